@@ -2,11 +2,16 @@
 
 #include "pros/rtos.hpp"
 #include "pros/imu.hpp"
+#include <array>
+#include <optional>
 #include "lemlib/asset.hpp"
 #include "lemlib/chassis/trackingWheel.hpp"
+#include "lemlib/chassis/driveOutput.hpp"
 #include "lemlib/pose.hpp"
 #include "lemlib/pid.hpp"
+#include "lemlib/gainSchedule.hpp"
 #include "lemlib/exitcondition.hpp"
+#include "lemlib/clock.hpp"
 #include "lemlib/driveCurve.hpp"
 
 namespace lemlib {
@@ -73,6 +78,11 @@ class ControllerSettings {
          * @param largeErrorTimeout the time the chassis controller will wait before exiting if error is within a
          * certain range determined by largeError
          * @param slew maximum acceleration
+         * @param kS static feed-forward gain. Output needed to overcome static friction. 0 by default
+         * @param kV velocity feed-forward gain. Output needed per inch per second. Only used by the lateral controller,
+         * since turns don't follow a velocity profile. 0 by default
+         * @param kA acceleration feed-forward gain. Output needed per inch per second squared. Only used by the lateral
+         * controller. 0 by default
          *
          * @b Example
          * @code {.cpp}
@@ -85,10 +95,20 @@ class ControllerSettings {
          *                                            3, // large error range, in inches
          *                                            500, // large error range timeout, in milliseconds
          *                                            5); // maximum acceleration (slew)
+         * // the same settings, with feed-forward gains found by Chassis::characterize
+         * lemlib::ControllerSettings modelledSettings(10, 0, 3, 3, 1, 100, 3, 500, 5,
+         *                                             6.2, // static feed-forward gain (kS)
+         *                                             1.8, // velocity feed-forward gain (kV)
+         *                                             0.15); // acceleration feed-forward gain (kA)
+         * // exit once the robot is stopped within the small error range, instead of waiting out the timeout
+         * modelledSettings.settleVelocity = 1; // robot is stopped below 1 inch per second
+         * modelledSettings.settleRate = 2; // and the error changes by less than 2 inches per second
+         * modelledSettings.settleTime = 30; // for 30 milliseconds
          * @endcode
          */
         ControllerSettings(float kP, float kI, float kD, float windupRange, float smallError, float smallErrorTimeout,
-                           float largeError, float largeErrorTimeout, float slew)
+                           float largeError, float largeErrorTimeout, float slew, float kS = 0, float kV = 0,
+                           float kA = 0)
             : kP(kP),
               kI(kI),
               kD(kD),
@@ -97,7 +117,19 @@ class ControllerSettings {
               smallErrorTimeout(smallErrorTimeout),
               largeError(largeError),
               largeErrorTimeout(largeErrorTimeout),
-              slew(slew) {}
+              slew(slew),
+              kS(kS),
+              kV(kV),
+              kA(kA) {}
+
+        /**
+         * @brief Calculate the output needed to reach a velocity and acceleration using the feed-forward gains
+         *
+         * @param velocity target velocity
+         * @param acceleration target acceleration
+         * @return float output, out of 127
+         */
+        float feedforward(float velocity, float acceleration) const;
 
         float kP;
         float kI;
@@ -108,6 +140,20 @@ class ControllerSettings {
         float largeError;
         float largeErrorTimeout;
         float slew;
+        float kS;
+        float kV;
+        float kA;
+        /** the maximum rate of change of the error, in units per second, for the robot to be considered stopped
+         * within the small error range. 0 ignores the error rate. 0 by default */
+        float settleRate = 0;
+        /** the maximum speed of the robot, in inches per second for the lateral controller or degrees per second for
+         * the angular controller, for time within the small error range to count. 0 ignores speed. 0 by default */
+        float settleVelocity = 0;
+        /** how long the robot has to be stopped within the small error range before the controller exits, in
+         * milliseconds. Only has an effect if settleRate or settleVelocity is non-zero. 0 by default */
+        float settleTime = 0;
+        /** gains to use instead of kP, kI, and kD, looked up every iteration of a motion. No schedule by default */
+        std::optional<GainSchedule> gainSchedule = std::nullopt;
 };
 
 /**
@@ -300,6 +346,10 @@ struct MoveToPoseParams {
         /** distance between the robot and target point where the movement will exit. Only has an effect if minSpeed is
          * non-zero.*/
         float earlyExitRange = 0;
+        /** whether the motion should blend into the motion queued after it. The robot slows down for the corner
+         * between the two motions instead of stopping, and the next motion starts with the power and controller state
+         * this motion ended with. Only has an effect if minSpeed is non-zero. False by default */
+        bool blend = false;
 };
 
 /**
@@ -321,6 +371,87 @@ struct MoveToPointParams {
         /** distance between the robot and target point where the movement will exit. Only has an effect if minSpeed is
          * non-zero.*/
         float earlyExitRange = 0;
+        /** whether the motion should blend into the motion queued after it. The robot slows down for the corner
+         * between the two motions instead of stopping, and the next motion starts with the power and controller state
+         * this motion ended with. Only has an effect if minSpeed is non-zero. False by default */
+        bool blend = false;
+        /** whether the robot should follow a planned velocity profile to the target instead of ramping with slew. The
+         * peak velocity is maxSpeed out of the theoretical top speed of the drivetrain. False by default */
+        bool profiled = false;
+        /** maximum acceleration of the velocity profile, in inches per second squared. 0 means it is calculated from
+         * the slew of the lateral controller. Only has an effect if profiled is true. 0 by default */
+        float maxAccel = 0;
+        /** maximum jerk of the velocity profile, in inches per second cubed. 0 plans a trapezoidal profile, otherwise
+         * an S-curve is used. Only has an effect if profiled is true. 0 by default */
+        float maxJerk = 0;
+};
+
+/**
+ * @brief Settings for the wheel velocity controller used by Chassis::follow
+ *
+ * Once any gain of the velocity controller is set, Chassis::follow tracks its target wheel velocities in inches per
+ * second. Each side of the drivetrain feeds forward the target through the feed-forward gains of the lateral
+ * controller, and a PID corrects the difference between the target and measured wheel velocity. With every gain at 0,
+ * which is the default, Chassis::follow sends its target velocities to the motors as power, without any feedback.
+ */
+struct VelocityControllerSettings {
+        /** proportional gain, in power per inch per second of velocity error. 0 by default */
+        float kP = 0;
+        /** integral gain. 0 by default */
+        float kI = 0;
+        /** derivative gain. 0 by default */
+        float kD = 0;
+        /** whether to calculate wheel velocity from odometry instead of the drivetrain motor encoders. Odometry is less
+         * affected by wheel slip if tracking wheels are used. False by default */
+        bool useOdom = false;
+};
+
+/**
+ * @brief Parameters for Chassis::characterize
+ *
+ * We use a struct to simplify customization. Chassis::characterize has many
+ * parameters and specifying them all just to set one optional param harms
+ * readability. By passing a struct to the function, we can have named
+ * parameters, overcoming the c/c++ limitation
+ */
+struct CharacterizeParams {
+        /** how fast the power increases during the quasistatic test, in power per second. 10 by default */
+        float rampRate = 10;
+        /** the power applied during the dynamic test. Value between 0-127. 80 by default */
+        float stepPower = 80;
+        /** the longest time each test can take, in milliseconds. 8000 by default */
+        int testTimeout = 8000;
+};
+
+/**
+ * @brief Enum class TuneTarget
+ *
+ * Chassis::autoTune can tune either of the chassis controllers. This enum class has 2 values, LATERAL and ANGULAR
+ */
+enum class TuneTarget {
+    LATERAL, /** tune the lateral controller, by driving back and forth */
+    ANGULAR /** tune the angular controller, by turning back and forth */
+};
+
+/**
+ * @brief Parameters for Chassis::autoTune
+ *
+ * We use a struct to simplify customization. Chassis::autoTune has many
+ * parameters and specifying them all just to set one optional param harms
+ * readability. By passing a struct to the function, we can have named
+ * parameters, overcoming the c/c++ limitation
+ */
+struct AutoTuneParams {
+        /** the power the relay switches between. Value between 0-127. 40 by default */
+        float relayPower = 40;
+        /** how far the error has to cross zero before the relay switches, so sensor noise doesn't make it chatter.
+         * In inches for the lateral controller, degrees for the angular controller. 0.5 by default */
+        float hysteresis = 0.5;
+        /** the number of oscillations to measure. The first oscillation is not measured, since it is still settling
+         * into a steady pattern. 5 by default */
+        int cycles = 5;
+        /** the longest time the test can take, in milliseconds. 10000 by default */
+        int timeout = 10000;
 };
 
 // default drive curve
@@ -482,6 +613,107 @@ class Chassis {
          * @endcode
          */
         void setBrakeMode(pros::motor_brake_mode_e mode);
+        /**
+         * @brief Set the settings of the wheel velocity controller used for path following
+         *
+         * Path following is open loop until a gain of the velocity controller is set. The target velocities are fed
+         * forward using kS, kV and kA of the lateral controller, or sent as power if its kV is 0
+         *
+         * @param settings the new settings
+         *
+         * @b Example
+         * @code {.cpp}
+         * // correct 2 power for every inch per second the wheels are slower than they should be
+         * chassis.setVelocityController({.kP = 2});
+         * @endcode
+         */
+        void setVelocityController(VelocityControllerSettings settings);
+        /**
+         * @brief Get the velocity of one side of the drivetrain
+         *
+         * @param side the side of the drivetrain
+         * @return float velocity of the side's wheels, in inches per second
+         *
+         * @b Example
+         * @code {.cpp}
+         * // print the velocity of the left side of the drivetrain
+         * std::cout << chassis.getWheelVelocity(lemlib::DriveSide::LEFT) << std::endl;
+         * @endcode
+         */
+        float getWheelVelocity(DriveSide side);
+        /**
+         * @brief Set the voltage that drivetrain power is normalized against
+         *
+         * Without compensation, the robot slows down as the battery drains. With it, a power of 127 always applies
+         * the nominal voltage to the motors, so routines run the same at the end of a match as on a fresh battery.
+         * The nominal voltage should be a bit lower than what a battery holds under load at the end of a match
+         *
+         * @param nominalVoltage nominal voltage, in volts. 0 disables compensation, which is the default
+         *
+         * @b Example
+         * @code {.cpp}
+         * void initialize() {
+         *     // 127 power always applies 11.5 volts
+         *     chassis.setNominalVoltage(11.5);
+         * }
+         * @endcode
+         */
+        void setNominalVoltage(float nominalVoltage);
+        /**
+         * @brief Get the factor drivetrain commands are multiplied by to compensate for the battery voltage
+         *
+         * @return float compensation factor. 1 if compensation is disabled
+         *
+         * @b Example
+         * @code {.cpp}
+         * // log the compensation factor
+         * lemlib::telemetrySink()->info("compensation: {}", chassis.getVoltageCompensation());
+         * @endcode
+         */
+        float getVoltageCompensation();
+        /**
+         * @brief Set how much a drivetrain command has to change by before it is sent to the motors again
+         *
+         * Redundant commands waste smart port bandwidth that could be used to read sensors
+         *
+         * @param epsilon the epsilon, in millivolts. 25 by default
+         *
+         * @b Example
+         * @code {.cpp}
+         * // only send commands that change by more than 50 mV
+         * chassis.setOutputEpsilon(50);
+         * @endcode
+         */
+        void setOutputEpsilon(int32_t epsilon);
+        /**
+         * @brief Get the number of drivetrain motor writes that were not sent because they were redundant
+         *
+         * @return uint32_t number of writes saved
+         *
+         * @b Example
+         * @code {.cpp}
+         * // log the number of writes saved
+         * lemlib::telemetrySink()->info("writes saved: {}", chassis.getWritesSaved());
+         * @endcode
+         */
+        uint32_t getWritesSaved() const;
+        /**
+         * @brief Set the clock motions use to time themselves
+         *
+         * Motions use the real time of the brain by default. The clock is also given to the exit conditions of the
+         * chassis. Motions wait on the clock between iterations, and rely on odometry updating the pose while they do,
+         * so the clock has to let other tasks run when it delays. A ManualClock doesn't, so it can't time motions
+         *
+         * @param clock pointer to the clock. Must outlive the chassis
+         *
+         * @b Example
+         * @code {.cpp}
+         * // time motions with a clock that follows the time of the match, instead of the time since the brain started
+         * MatchClock clock;
+         * chassis.setClock(&clock);
+         * @endcode
+         */
+        void setClock(Clock* clock);
         /**
          * @brief Turn the chassis so it is facing the target point
          *
@@ -677,6 +909,9 @@ class Chassis {
          * // move the robot to x = 7.5, y = 7.5 with a timeout of 4000ms
          * // with a minSpeed of 60, and exit the movement if the robot is within 5 inches of the target
          * chassis.moveToPoint(7.5, 7.5, 4000, {.minSpeed = 60, .earlyExitRange = 5});
+         * // move the robot to x = 0, y = 48 with a timeout of 4000ms
+         * // following a trapezoidal velocity profile that accelerates at 100 inches per second squared
+         * chassis.moveToPoint(0, 48, 4000, {.profiled = true, .maxAccel = 100});
          * @endcode
          */
         void moveToPoint(float x, float y, int timeout, MoveToPointParams params = {}, bool async = true);
@@ -708,6 +943,55 @@ class Chassis {
          * @endcode
          */
         void follow(const asset& path, float lookahead, int timeout, bool forwards = true, bool async = true);
+        /**
+         * @brief Find the feed-forward gains of the drivetrain
+         *
+         * The robot first drives forwards while slowly ramping up the power (quasistatic test), then drives backwards
+         * at a constant power (dynamic test). Each test ends once the robot has traveled maxDistance. The static,
+         * velocity and acceleration gains are fit to the recorded data, and the result is logged through the info sink
+         * at the INFO level. The gains can then be passed to the lateral ControllerSettings
+         *
+         * @param maxDistance the furthest the robot can travel during each test, in inches
+         * @param params struct to simulate named parameters
+         * @param async whether the function should be run asynchronously. true by default
+         *
+         * @b Example
+         * @code {.cpp}
+         * void autonomous() {
+         *     lemlib::infoSink()->setLowestLevel(lemlib::Level::INFO);
+         *     // characterize the drivetrain, with 60 inches of free space in front of the robot
+         *     chassis.characterize(60);
+         *     chassis.waitUntilDone();
+         * }
+         * @endcode
+         */
+        void characterize(float maxDistance, CharacterizeParams params = {}, bool async = true);
+        /**
+         * @brief Find PID gains for a chassis controller with a relay feedback test
+         *
+         * The robot holds its starting position or heading by switching between full positive and negative relay
+         * power, which makes it oscillate around the target. The amplitude and period of the oscillations give the
+         * ultimate gain and period of the drivetrain, and suggested ControllerSettings are calculated from them with
+         * Ziegler-Nichols style rules. The results are logged through the info sink at the INFO level
+         *
+         * @param target the controller to tune
+         * @param params struct to simulate named parameters
+         * @param async whether the function should be run asynchronously. true by default
+         *
+         * @b Example
+         * @code {.cpp}
+         * void autonomous() {
+         *     lemlib::infoSink()->setLowestLevel(lemlib::Level::INFO);
+         *     // tune the angular controller
+         *     chassis.autoTune(lemlib::TuneTarget::ANGULAR);
+         *     chassis.waitUntilDone();
+         *     // tune the lateral controller, with a smaller relay power
+         *     chassis.autoTune(lemlib::TuneTarget::LATERAL, {.relayPower = 30});
+         *     chassis.waitUntilDone();
+         * }
+         * @endcode
+         */
+        void autoTune(TuneTarget target, AutoTuneParams params = {}, bool async = true);
         /**
          * @brief Control the robot during the driver using the tank drive control scheme. In this control scheme one
          * joystick axis controls the left motors' forward and backwards movement of the robot, while the other joystick
@@ -896,15 +1180,15 @@ class Chassis {
          */
         void resetLocalPosition();
         /**
-         * PIDs are exposed so advanced users can implement things like gain scheduling
-         * Changes are immediate and will affect a motion in progress
+         * PIDs are exposed so advanced users can implement custom behaviour. For gain scheduling, use the gainSchedule
+         * of ControllerSettings instead. Changes are immediate and will affect a motion in progress
          *
          * @warning Do not interact with these unless you know what you are doing
          */
         PID lateralPID;
         /**
-         * PIDs are exposed so advanced users can implement things like gain scheduling
-         * Changes are immediate and will affect a motion in progress
+         * PIDs are exposed so advanced users can implement custom behaviour. For gain scheduling, use the gainSchedule
+         * of ControllerSettings instead. Changes are immediate and will affect a motion in progress
          *
          * @warning Do not interact with these unless you know what you are doing
          */
@@ -919,22 +1203,100 @@ class Chassis {
          */
         void endMotion();
 
+        /**
+         * @brief State handed from a motion that blended into the next motion
+         */
+        struct MotionHandoff {
+                /** lateral power when the motion exited */
+                float lateralOut = 0;
+                /** angular power when the motion exited */
+                float angularOut = 0;
+                /** time the motion exited, in milliseconds */
+                uint32_t time = 0;
+        };
+
+        /**
+         * @brief Stop the drivetrain at the end of a motion, or leave it running for the queued motion
+         *
+         * @param blend whether the motion exited early to blend into the queued motion
+         * @param lateralOut the last lateral power of the motion
+         * @param angularOut the last angular power of the motion
+         */
+        void stopOrHandoff(bool blend, float lateralOut, float angularOut);
+        /**
+         * @brief Take the state handed off by the previous motion
+         *
+         * Every motion takes it when it starts, even if it doesn't use it, so a handoff never reaches a motion that
+         * didn't directly follow the one that blended
+         *
+         * @return std::optional<MotionHandoff> the handoff, or std::nullopt if the previous motion stopped
+         */
+        std::optional<MotionHandoff> takeHandoff();
+        /**
+         * @brief Calculate the fastest a blending motion can go and still make the corner into the queued motion
+         *
+         * The power allowed at the target depends on how sharp the corner is, and the robot decelerates towards it
+         * using the slew of the lateral controller
+         *
+         * @param target the target of the running motion
+         * @param heading the direction the robot travels in as it reaches the target, in radians in standard form
+         * @param distance distance to the target
+         * @param minSpeed the minimum speed of the running motion
+         * @param maxSpeed the maximum speed of the running motion
+         * @param forwards whether the running motion drives forwards
+         * @return float the maximum lateral power. maxSpeed if the target of the queued motion is unknown
+         */
+        float getBlendSpeed(Pose target, float heading, float distance, float minSpeed, float maxSpeed, bool forwards);
+        /**
+         * @brief Set the gains of a PID from the gain schedule of its controller, if it has one
+         *
+         * @param pid the PID to update
+         * @param settings the settings of the controller the PID belongs to
+         * @param error the error on the current iteration
+         * @param speed the measured speed of the robot
+         * @param motionSize the error when the motion started
+         */
+        void scheduleGains(PID& pid, const ControllerSettings& settings, float error, float speed, float motionSize);
+
+        /**
+         * @brief The motors of one side of the drivetrain, and how to convert their velocity to wheel velocity
+         *
+         * Gearsets are only read when the size of the motor group changes, so measuring wheel velocity only reads the
+         * velocity of each motor
+         */
+        struct WheelMotors {
+                /** inches per second of wheel velocity per rpm of each motor */
+                std::array<float, 21> scale;
+                size_t count = 0;
+        };
+
         bool motionRunning = false;
         bool motionQueued = false;
 
         float distTraveled = 0;
 
+        std::optional<Pose> queuedTarget = std::nullopt;
+        // whether the queued motion drives forwards
+        bool queuedForwards = true;
+        std::optional<MotionHandoff> handoff = std::nullopt;
+
         ControllerSettings lateralSettings;
         ControllerSettings angularSettings;
         Drivetrain drivetrain;
+        DriveOutput driveOutput;
         OdomSensors sensors;
         DriveCurve* throttleCurve;
         DriveCurve* steerCurve;
+        VelocityControllerSettings velocitySettings;
+        WheelMotors leftWheelMotors;
+        WheelMotors rightWheelMotors;
 
         ExitCondition lateralLargeExit;
         ExitCondition lateralSmallExit;
         ExitCondition angularLargeExit;
         ExitCondition angularSmallExit;
+
+        Clock* clock = realClock();
     private:
         pros::Mutex mutex;
 };
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include "pros/motor_group.hpp"
+
+namespace lemlib {
+/**
+ * @brief Output stage between the chassis controllers and the drivetrain motors
+ *
+ * Controllers output power out of 127. The output stage converts it to a voltage, and if voltage compensation is
+ * enabled, scales it so the motors receive the same voltage no matter how charged the battery is. The battery voltage
+ * is only sampled every few hundred milliseconds, so the control loop doesn't pay for it every iteration. The battery
+ * voltage and compensation can be read from any task.
+ *
+ * Commands are staged, and only sent to the motors when flush() is called, which the chassis does once per iteration.
+ * The last command sent to each motor is cached, and a command that is within the epsilon of the cached one is not
+ * sent again, so the bandwidth of the smart ports goes to reading sensors instead. Cached commands are still resent
+ * every so often, in case something else wrote to the motors or a motor was reconnected.
+ */
+class DriveOutput {
+    public:
+        /**
+         * @brief Construct a new Drive Output
+         *
+         * @param leftMotors pointer to the left motors
+         * @param rightMotors pointer to the right motors
+         */
+        DriveOutput(pros::MotorGroup* leftMotors, pros::MotorGroup* rightMotors);
+        /**
+         * @brief Set the voltage that power is normalized against
+         *
+         * With a nominal voltage of 11 volts, a power of 127 will always apply 11 volts, as long as the battery can
+         * supply it. The nominal voltage should be a bit below what a battery holds under load at the end of a match
+         *
+         * @param nominalVoltage nominal voltage, in volts. 0 disables compensation
+         */
+        void setNominalVoltage(float nominalVoltage);
+        /**
+         * @brief Get the factor commands are multiplied by to compensate for the battery voltage
+         *
+         * @return float compensation factor. 1 if compensation is disabled
+         */
+        float getCompensation();
+        /**
+         * @brief Get the last sampled battery voltage
+         *
+         * @return float battery voltage, in volts
+         */
+        float getBatteryVoltage();
+        /**
+         * @brief Set how much a command has to change by before it is sent to the motors again
+         *
+         * Commands to stop the motors are always sent, no matter how small the change is
+         *
+         * @param epsilon the epsilon, in millivolts. 0 only suppresses commands identical to the last one
+         */
+        void setEpsilon(int32_t epsilon);
+        /**
+         * @brief Send the staged commands to the motors
+         *
+         * Should be called once per iteration of the control loop, after all the commands for that iteration have
+         * been staged
+         */
+        void flush();
+        /**
+         * @brief Get the number of commands sent to individual motors
+         *
+         * @return uint32_t number of writes sent
+         */
+        uint32_t getWritesSent() const;
+        /**
+         * @brief Get the number of commands to individual motors that were not sent because they were redundant
+         *
+         * @return uint32_t number of writes saved
+         */
+        uint32_t getWritesSaved() const;
+        /**
+         * @brief Stage a command for both sides of the drivetrain
+         *
+         * @param leftPower power of the left side, from -127 to 127
+         * @param rightPower power of the right side, from -127 to 127
+         */
+        void move(float leftPower, float rightPower);
+        /**
+         * @brief Stage a command for the left side of the drivetrain
+         *
+         * @param power power from -127 to 127
+         */
+        void moveLeft(float power);
+        /**
+         * @brief Stage a command for the right side of the drivetrain
+         *
+         * @param power power from -127 to 127
+         */
+        void moveRight(float power);
+        /**
+         * @brief Stage a command to brake the left side of the drivetrain, using its brake mode
+         */
+        void brakeLeft();
+        /**
+         * @brief Stage a command to brake the right side of the drivetrain, using its brake mode
+         */
+        void brakeRight();
+    private:
+        /**
+         * @brief A command for a motor, either a voltage or a brake
+         */
+        struct MotorCommand {
+                bool brake = false;
+                int32_t millivolts = 0;
+        };
+
+        /**
+         * @brief The last command sent to a single motor
+         */
+        struct CachedCommand {
+                MotorCommand command;
+                uint32_t time = 0;
+                bool valid = false;
+        };
+
+        /**
+         * @brief A side of the drivetrain, with its staged command and the commands cached for each motor
+         */
+        struct Side {
+                pros::MotorGroup* motors;
+                std::optional<MotorCommand> staged;
+                std::vector<int8_t> ports;
+                std::vector<CachedCommand> cache;
+        };
+
+        /**
+         * @brief Check whether a command would change what a motor is doing
+         *
+         * @param cached the last command sent to the motor
+         * @param command the new command
+         * @param now the current time, in milliseconds
+         * @return true the command needs to be sent
+         * @return false the command is redundant
+         */
+        bool needsWrite(const CachedCommand& cached, const MotorCommand& command, uint32_t now) const;
+        /**
+         * @brief Send the staged command of a side to its motors
+         *
+         * @param side the side to flush
+         * @param now the current time, in milliseconds
+         */
+        void flushSide(Side& side, uint32_t now);
+        /**
+         * @brief Convert power to a compensated voltage
+         *
+         * @param power power from -127 to 127
+         * @return int32_t voltage in millivolts, from -12000 to 12000
+         */
+        int32_t toMillivolts(float power);
+        /**
+         * @brief Sample the battery voltage if the last sample is too old
+         */
+        void updateBattery();
+
+        Side left;
+        Side right;
+        int32_t epsilon = 25;
+        uint32_t writesSent = 0;
+        uint32_t writesSaved = 0;
+        float nominalVoltage = 0;
+        // the battery is sampled by whichever task reads it
+        std::atomic<float> batteryVoltage = 12;
+        std::atomic<uint32_t> lastSampleTime = 0;
+        std::atomic<bool> sampled = false;
+};
+} // namespace lemlib
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <vector>
+#include "lemlib/asset.hpp"
+#include "lemlib/pose.hpp"
+
+namespace lemlib {
+/**
+ * @brief Read the points of a path from an asset
+ *
+ * Each line of the asset is a point, as "x, y, velocity", and the path ends at a line reading "endData"
+ *
+ * @param path the asset to read
+ * @return std::vector<Pose> points on the path. The theta of each point holds its velocity, out of 127
+ */
+std::vector<Pose> readPath(const asset& path);
+} // namespace lemlib
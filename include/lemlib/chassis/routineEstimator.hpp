@@ -0,0 +1,241 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "lemlib/asset.hpp"
+#include "lemlib/pose.hpp"
+#include "lemlib/chassis/chassis.hpp"
+
+namespace lemlib {
+/**
+ * @brief Estimated duration of a single motion in a routine
+ */
+struct MotionEstimate {
+        /** name of the motion, like "moveToPoint" */
+        std::string name;
+        /** position of the motion in the routine, starting at 0 */
+        int index;
+        /** estimated duration, in milliseconds. Never longer than the timeout */
+        float duration;
+        /** timeout of the motion, in milliseconds */
+        float timeout;
+        /** whether the motion is expected to run into its timeout */
+        bool timesOut;
+};
+
+/**
+ * @brief Estimates how long an autonomous routine takes, without running it
+ *
+ * The estimator has the same motion functions as the chassis, so a routine can be estimated by calling them on the
+ * estimator instead. Each motion steps a model of its controllers every 10 ms, with the same gains, slew, and exit
+ * conditions as the motion. The drivetrain follows the power it is given with a lag, and tops out below the free speed
+ * of its motors, so the controllers overshoot and settle the way they do on a robot, and motions that overshoot out of
+ * the small error range wait for the large error timeout. Drives turn towards their target as they go. Motions with a
+ * minSpeed exit without settling. On the routine of sim/example.cpp the estimate is within 15% of the simulator, which
+ * sim/estimatecheck.cpp checks. Wheel slip and battery sag aren't modelled, so leave some margin in the budget.
+ *
+ * @b Example
+ * @code {.cpp}
+ * lemlib::RoutineEstimator estimator(drivetrain, linearController, angularController);
+ * estimator.setPose(0, 0, 0);
+ * estimator.moveToPoint(0, 48, 2000);
+ * estimator.turnToHeading(90, 1000);
+ * estimator.moveToPose(48, 48, 90, 3000);
+ * // log the estimate, and warn if the routine takes longer than 15 seconds
+ * estimator.report();
+ * @endcode
+ */
+class RoutineEstimator {
+    public:
+        /**
+         * @brief Construct a new Routine Estimator
+         *
+         * @param drivetrain drivetrain of the chassis
+         * @param linearSettings settings of the lateral controller
+         * @param angularSettings settings of the angular controller
+         * @param budget how long the routine can take, in milliseconds. 15000 by default
+         */
+        RoutineEstimator(Drivetrain drivetrain, ControllerSettings linearSettings, ControllerSettings angularSettings,
+                         float budget = 15000);
+        /**
+         * @brief Set where the robot starts, or is moved to by something other than a motion
+         *
+         * @param x x position, in inches
+         * @param y y position, in inches
+         * @param theta heading, in degrees
+         */
+        void setPose(float x, float y, float theta);
+        /**
+         * @brief Estimate Chassis::moveToPoint
+         *
+         * @param x x position of the target
+         * @param y y position of the target
+         * @param timeout longest time the robot can spend moving
+         * @param params struct to simulate named parameters
+         */
+        void moveToPoint(float x, float y, int timeout, MoveToPointParams params = {});
+        /**
+         * @brief Estimate Chassis::moveToPose, from the length and the corners of the boomerang curve
+         *
+         * @param x x position of the target
+         * @param y y position of the target
+         * @param theta target heading, in degrees
+         * @param timeout longest time the robot can spend moving
+         * @param params struct to simulate named parameters
+         */
+        void moveToPose(float x, float y, float theta, int timeout, MoveToPoseParams params = {});
+        /**
+         * @brief Estimate Chassis::turnToHeading
+         *
+         * @param theta target heading, in degrees
+         * @param timeout longest time the robot can spend turning
+         * @param params struct to simulate named parameters
+         */
+        void turnToHeading(float theta, int timeout, TurnToHeadingParams params = {});
+        /**
+         * @brief Estimate Chassis::turnToPoint
+         *
+         * @param x x position of the point to face
+         * @param y y position of the point to face
+         * @param timeout longest time the robot can spend turning
+         * @param params struct to simulate named parameters
+         */
+        void turnToPoint(float x, float y, int timeout, TurnToPointParams params = {});
+        /**
+         * @brief Estimate Chassis::swingToHeading. The robot turns about its locked side
+         *
+         * @param theta target heading, in degrees
+         * @param lockedSide side of the drivetrain that is locked
+         * @param timeout longest time the robot can spend turning
+         * @param params struct to simulate named parameters
+         */
+        void swingToHeading(float theta, DriveSide lockedSide, int timeout, SwingToHeadingParams params = {});
+        /**
+         * @brief Estimate Chassis::swingToPoint. The robot turns about its locked side
+         *
+         * @param x x position of the point to face
+         * @param y y position of the point to face
+         * @param lockedSide side of the drivetrain that is locked
+         * @param timeout longest time the robot can spend turning
+         * @param params struct to simulate named parameters
+         */
+        void swingToPoint(float x, float y, DriveSide lockedSide, int timeout, SwingToPointParams params = {});
+        /**
+         * @brief Estimate Chassis::follow, from the velocities stored in the path
+         *
+         * @param path the path asset to follow
+         * @param lookahead lookahead distance, in inches. Doesn't affect the estimate
+         * @param timeout longest time the robot can spend following the path
+         * @param forwards whether the robot follows the path forwards. True by default
+         */
+        void follow(const asset& path, float lookahead, int timeout, bool forwards = true);
+        /**
+         * @brief Add time where the robot doesn't move, like waiting for a mechanism
+         *
+         * @param time how long to wait, in milliseconds
+         */
+        void delay(int time);
+        /**
+         * @brief Get the estimate of every motion, in the order they run
+         *
+         * @return const std::vector<MotionEstimate>& the estimates
+         */
+        const std::vector<MotionEstimate>& getMotions() const;
+        /**
+         * @brief Get the estimated duration of the whole routine
+         *
+         * @return float duration, in milliseconds
+         */
+        float getDuration() const;
+        /**
+         * @brief Check whether the routine fits in the budget
+         *
+         * @return true the routine is expected to finish in time
+         * @return false the routine is expected to run past the budget
+         */
+        bool fitsBudget() const;
+        /**
+         * @brief Get the motions that take the longest
+         *
+         * @param count how many motions to get. 3 by default
+         * @return std::vector<MotionEstimate> the motions, longest first
+         */
+        std::vector<MotionEstimate> getMostExpensive(size_t count = 3) const;
+        /**
+         * @brief Log the estimate of every motion, and warn if the routine runs past the budget or a motion is
+         * expected to time out
+         */
+        void report() const;
+    private:
+        /**
+         * @brief Estimate how long a controller takes to reach its target
+         *
+         * @param distance distance to the target, in the units of the controller
+         * @param maxSpeed max power, out of 127
+         * @param minSpeed min power, out of 127. Motions with a min speed don't settle
+         * @param freeSpeed how fast the robot moves at full power, in the units of the controller per second
+         * @param timeout timeout of the motion, in milliseconds
+         * @param settings settings of the controller
+         * @return float estimated duration, in milliseconds. Longer than the timeout if the motion times out
+         */
+        float estimateMotion(float distance, float maxSpeed, float minSpeed, float freeSpeed, float timeout,
+                             const ControllerSettings& settings) const;
+        /**
+         * @brief Estimate how long the lateral controller takes to drive a distance
+         *
+         * @param distance distance to drive, in inches
+         * @param maxSpeed max power, out of 127
+         * @param minSpeed min power, out of 127. Motions with a min speed don't settle
+         * @param timeout timeout of the motion, in milliseconds
+         * @param heading how far the robot has to turn to face the way it drives, in degrees. 0 by default
+         * @return float estimated duration, in milliseconds. Longer than the timeout if the motion times out
+         */
+        float estimateDrive(float distance, float maxSpeed, float minSpeed, float timeout, float heading = 0) const;
+        /**
+         * @brief Estimate how long the angular controller takes to turn an angle
+         *
+         * @param angle angle to turn, in degrees
+         * @param maxSpeed max power, out of 127
+         * @param minSpeed min power, out of 127. Motions with a min speed don't settle
+         * @param swing whether the robot swings about one side instead of turning in place
+         * @param timeout timeout of the motion, in milliseconds
+         * @return float estimated duration, in milliseconds. Longer than the timeout if the motion times out
+         */
+        float estimateTurn(float angle, float maxSpeed, float minSpeed, bool swing, float timeout) const;
+        /**
+         * @brief Record the estimate of a motion
+         *
+         * @param name name of the motion
+         * @param duration estimated duration, in milliseconds
+         * @param timeout timeout of the motion, in milliseconds
+         */
+        void add(const std::string& name, float duration, float timeout);
+        /**
+         * @brief Get the top speed of the drivetrain
+         *
+         * @return float top speed, in inches per second
+         */
+        float getMaxVelocity() const;
+        /**
+         * @brief Get how fast the robot turns at full power
+         *
+         * @param swing whether the robot swings about one side instead of turning in place
+         * @return float turn speed, in degrees per second
+         */
+        float getTurnSpeed(bool swing) const;
+        /**
+         * @brief Get the acceleration a slew rate allows
+         *
+         * @param slew the slew rate, in power per 10 milliseconds. 0 if there is no slew limit
+         * @return float the acceleration, in inches per second squared
+         */
+        float getAcceleration(float slew) const;
+
+        Drivetrain drivetrain;
+        ControllerSettings linearSettings;
+        ControllerSettings angularSettings;
+        float budget;
+        Pose pose = Pose(0, 0, 0);
+        std::vector<MotionEstimate> motions;
+};
+} // namespace lemlib
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace lemlib {
+/**
+ * @brief Source of time for timers, exit conditions, and motions
+ *
+ * On the robot, the real clock reads the time from the RTOS. Code that is tested on a computer can use a ManualClock
+ * instead, which only moves when it is told to, so tests of timing behavior run as fast as the computer can run them
+ * instead of taking as long as they would on the robot
+ */
+class Clock {
+    public:
+        virtual ~Clock() = default;
+        /**
+         * @brief Get the current time
+         *
+         * @return uint32_t time, in milliseconds
+         */
+        virtual uint32_t millis() const = 0;
+        /**
+         * @brief Wait for some time to pass
+         *
+         * @param time how long to wait, in milliseconds
+         */
+        virtual void delay(uint32_t time) = 0;
+};
+
+/**
+ * @brief Clock that reads the time from the RTOS
+ */
+class RealClock : public Clock {
+    public:
+        uint32_t millis() const override;
+        void delay(uint32_t time) override;
+};
+
+/**
+ * @brief Clock that only moves when it is told to
+ *
+ * Delaying advances the clock instead of waiting, since nothing else will advance it. It doesn't yield to other tasks
+ * either, so code run on a manual clock can't depend on another task making progress, like odometry updating the pose.
+ * Timers and exit conditions can be stepped with it, which sim/clockcheck.cpp does
+ *
+ * @b Example
+ * @code {.cpp}
+ * lemlib::ManualClock clock;
+ * lemlib::Timer timer(1000, &clock);
+ * clock.advance(999);
+ * timer.isDone(); // false
+ * clock.advance(1);
+ * timer.isDone(); // true
+ * @endcode
+ */
+class ManualClock : public Clock {
+    public:
+        /**
+         * @brief Construct a new Manual Clock
+         *
+         * @param start the time the clock starts at, in milliseconds. 0 by default
+         */
+        ManualClock(uint32_t start = 0);
+        uint32_t millis() const override;
+        void delay(uint32_t time) override;
+        /**
+         * @brief Move the clock forwards
+         *
+         * @param time how far to move the clock, in milliseconds
+         */
+        void advance(uint32_t time);
+        /**
+         * @brief Set the time of the clock
+         *
+         * @param time the new time, in milliseconds
+         */
+        void set(uint32_t time);
+    private:
+        std::atomic<uint32_t> time;
+};
+
+/**
+ * @brief Get the real clock, which everything uses unless it is given another clock
+ *
+ * @return Clock* the real clock
+ */
+Clock* realClock();
+} // namespace lemlib
@@ -1,6 +1,17 @@
 #pragma once
 
+#include <cstdint>
+#include "lemlib/clock.hpp"
+
 namespace lemlib {
+/**
+ * @brief Exits once the input has been within a range for long enough
+ *
+ * If a maximum error rate or velocity is given, the exit condition is velocity aware. Time spent within the range
+ * doesn't count while the robot is moving faster than the maximum velocity, so it can't settle while coasting through
+ * the range. Once the input is within the range and both the error rate and the velocity are below their maximums,
+ * the robot is considered stopped, and the exit condition exits after the stop time instead of the full time.
+ */
 class ExitCondition {
     public:
         /**
@@ -16,6 +27,25 @@ class ExitCondition {
          * @endcode
          */
         ExitCondition(const float range, const int time);
+        /**
+         * @brief Create a new velocity aware Exit Condition
+         *
+         * @param range the range where the countdown is allowed to start
+         * @param time how much time to wait while in range before exiting
+         * @param maxRate the maximum rate of change of the input, in units per second, for the robot to be considered
+         * stopped. 0 to ignore the rate
+         * @param maxVelocity the maximum velocity of the robot for time spent in range to count. 0 to ignore velocity
+         * @param stopTime how much time to wait while in range and stopped before exiting
+         *
+         * @b Example
+         * @code {.cpp}
+         * // exit if the input is within 1 of the target for 500ms, or if it is within 1 of the target and the
+         * // robot has been stopped for 50ms
+         * ExitCondition ec(1, 500, 2, 1, 50);
+         * @endcode
+         */
+        ExitCondition(const float range, const int time, const float maxRate, const float maxVelocity,
+                      const int stopTime);
         /**
          * @brief whether the exit condition has been met
          *
@@ -32,7 +62,20 @@ class ExitCondition {
          */
         bool getExit();
         /**
-         * @brief update the exit condition
+         * @brief set the clock used by update when it isn't given the time
+         *
+         * @param clock the clock. The real clock by default
+         *
+         * @b Example
+         * @code {.cpp}
+         * // step time manually in a test
+         * lemlib::ManualClock clock;
+         * ec.setClock(&clock);
+         * @endcode
+         */
+        void setClock(Clock* clock);
+        /**
+         * @brief update the exit condition at the current time of its clock
          *
          * @param input the input for the exit condition
          * @return true exit condition met
@@ -49,6 +92,43 @@ class ExitCondition {
          * @endcode
          */
         bool update(const float input);
+        /**
+         * @brief update the exit condition at a given time
+         *
+         * Control loops should read the time once per iteration and pass it to all their exit conditions, so they
+         * agree on when the iteration happened
+         *
+         * @param input the input for the exit condition
+         * @param time the time of the update, in milliseconds
+         * @param velocity the measured velocity of the robot. Only used if the exit condition is velocity aware
+         * @return true exit condition met
+         * @return false exit condition not met
+         *
+         * @b Example
+         * @code {.cpp}
+         * while (!ec.getExit()) {
+         *     const uint32_t now = pros::millis();
+         *     ec.update(error, now, velocity);
+         *     pros::delay(10);
+         * }
+         * @endcode
+         */
+        bool update(const float input, const uint32_t time, const float velocity = 0);
+        /**
+         * @brief predict how long it will take for the exit condition to be met
+         *
+         * If the input is out of range, the current rate of change of the input is extrapolated to when it will
+         * reach the range
+         *
+         * @return float the predicted time, in milliseconds. -1 if the input isn't converging
+         *
+         * @b Example
+         * @code {.cpp}
+         * // log how long the motion is expected to take to settle
+         * lemlib::infoSink()->debug("settling in {} ms", ec.predictSettleTime());
+         * @endcode
+         */
+        float predictSettleTime() const;
         /**
          * @brief reset the exit condition timer
          *
@@ -62,7 +142,16 @@ class ExitCondition {
     protected:
         const float range;
         const int time;
+        const float maxRate = 0;
+        const float maxVelocity = 0;
+        const int stopTime = 0;
         int startTime = -1;
+        int stopStartTime = -1;
+        int prevTime = -1;
+        float prevInput = 0;
+        float rate = 0;
+        bool hasRate = false;
         bool done = false;
+        Clock* clock = realClock();
 };
 } // namespace lemlib
\ No newline at end of file
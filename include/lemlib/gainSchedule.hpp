@@ -0,0 +1,98 @@
+#pragma once
+
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace lemlib {
+/**
+ * @brief The variable a gain schedule is looked up with
+ */
+enum class ScheduleVariable {
+    ERROR, /** magnitude of the error on the current iteration */
+    SPEED, /** measured speed of the robot, in inches per second or degrees per second */
+    MOTION_SIZE /** magnitude of the error when the motion started. The distance of a movement, or the size of a turn */
+};
+
+/**
+ * @brief Format a schedule variable
+ *
+ * @param variable the variable to format
+ * @return std::string the name of the variable
+ */
+std::string format_as(ScheduleVariable variable);
+
+/**
+ * @brief PID gains at a point in a gain schedule
+ */
+struct ScheduledGains {
+        /** value of the schedule variable these gains are used at */
+        float value;
+        /** proportional gain */
+        float kP;
+        /** integral gain */
+        float kI;
+        /** derivative gain */
+        float kD;
+};
+
+/**
+ * @brief Table of PID gains, looked up by a variable every iteration of a motion
+ *
+ * Gains between two points in the table are linearly interpolated. Below the first point and above the last point,
+ * the gains of that point are used.
+ */
+class GainSchedule {
+    public:
+        /**
+         * @brief Construct a new Gain Schedule
+         *
+         * @param variable the variable the gains are looked up with
+         * @param points the points in the table. They don't have to be sorted
+         *
+         * @b Example
+         * @code {.cpp}
+         * // small turns need more proportional gain than large turns to be just as fast
+         * lemlib::GainSchedule turnSchedule(lemlib::ScheduleVariable::MOTION_SIZE, {
+         *     {15, 4, 0, 20}, // 15 degree turns use a kP of 4 and a kD of 20
+         *     {90, 2, 0, 10},
+         *     {180, 1.6, 0, 9} // 180 degree turns use a kP of 1.6 and a kD of 9
+         * });
+         * angularSettings.gainSchedule = turnSchedule;
+         * @endcode
+         */
+        GainSchedule(ScheduleVariable variable, std::initializer_list<ScheduledGains> points);
+        /**
+         * @brief Get the variable the gains are looked up with
+         *
+         * @return ScheduleVariable the variable
+         */
+        ScheduleVariable getVariable() const;
+        /**
+         * @brief Interpolate the gains at a value of the schedule variable
+         *
+         * @param value the value of the schedule variable
+         * @return ScheduledGains the interpolated gains
+         */
+        ScheduledGains get(float value) const;
+        /**
+         * @brief Interpolate the gains, picking the value of the schedule variable from the state of a motion
+         *
+         * @param error the error on the current iteration
+         * @param speed the measured speed of the robot
+         * @param motionSize the error when the motion started
+         * @return ScheduledGains the interpolated gains
+         */
+        ScheduledGains get(float error, float speed, float motionSize) const;
+        /**
+         * @brief Whether the schedule has any points
+         *
+         * @return true the schedule has no points
+         * @return false the schedule has points
+         */
+        bool empty() const;
+    private:
+        ScheduleVariable variable;
+        std::vector<ScheduledGains> points;
+};
+} // namespace lemlib
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace lemlib {
+/**
+ * @brief Preallocated memory that log messages are formatted into
+ *
+ * The arena is a fixed number of fixed-size slabs, allocated once. Formatting a message takes a slab, and the slab is
+ * given back as soon as the message has been copied into the buffer it is sent through, so logging doesn't allocate
+ * and can't fragment the heap, no matter how long the program runs. Taking and giving back a slab is lock free.
+ *
+ * If every slab is in use, because more tasks are logging at the same time than there are slabs, the message is
+ * formatted into memory allocated just for it instead. getOverflows() counts how often that happens.
+ *
+ * Messages longer than a slab are truncated.
+ */
+class LogArena {
+    public:
+        /**
+         * @brief A slab taken from the arena. Given back when it is destroyed
+         */
+        class Slab {
+            public:
+                Slab(Slab&& other) noexcept;
+                Slab(const Slab&) = delete;
+                Slab& operator=(const Slab&) = delete;
+                Slab& operator=(Slab&&) = delete;
+                ~Slab();
+
+                /**
+                 * @brief Get the memory of the slab
+                 */
+                char* data() const { return memory; }
+
+                /**
+                 * @brief Get the size of the slab, in bytes
+                 */
+                size_t capacity() const { return size; }
+            private:
+                friend class LogArena;
+                Slab(LogArena* arena, uint8_t index, char* memory, size_t size);
+
+                // nullptr if the memory was allocated because the arena was full
+                LogArena* arena;
+                uint8_t index;
+                char* memory;
+                size_t size;
+                std::unique_ptr<char[]> overflow;
+        };
+
+        /**
+         * @brief Construct a new Log Arena
+         *
+         * @param slabSize size of each slab, which is the longest message that can be formatted. 512 by default
+         * @param slabCount number of slabs, at most 32. 16 by default
+         */
+        LogArena(size_t slabSize = 512, uint8_t slabCount = 16);
+
+        LogArena(const LogArena&) = delete;
+        LogArena& operator=(const LogArena&) = delete;
+
+        /**
+         * @brief Take a free slab
+         *
+         * @return Slab the slab. Allocated separately if every slab is in use
+         */
+        Slab acquire();
+
+        /**
+         * @brief Get the size of each slab, in bytes
+         */
+        size_t getSlabSize() const;
+
+        /**
+         * @brief Get the number of slabs that had to be allocated because every slab was in use
+         */
+        uint32_t getOverflows() const;
+    private:
+        /**
+         * @brief Give a slab back
+         */
+        void release(uint8_t index);
+
+        const size_t slabSize;
+        const uint8_t slabCount;
+        std::unique_ptr<char[]> memory;
+        // a bit for each slab, set while it is in use
+        std::atomic<uint32_t> used = 0;
+        std::atomic<uint32_t> overflows = 0;
+};
+
+/**
+ * @brief Get the arena LemLib's logger formats messages into
+ *
+ */
+LogArena& logArena();
+} // namespace lemlib
@@ -1,15 +1,44 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstring>
 #include <initializer_list>
+#include <memory>
+#include <tuple>
+#include <type_traits>
 #include "pros/rtos.hpp"
 
 #define FMT_HEADER_ONLY
 #include "fmt/core.h"
 #include "fmt/args.h"
 
+#include "lemlib/logger/arena.hpp"
+#include "lemlib/logger/buffer.hpp"
 #include "lemlib/logger/message.hpp"
+#include "lemlib/logger/stdout.hpp"
+#include "lemlib/pose.hpp"
+#include "lemlib/profiler.hpp"
 
 namespace lemlib {
+/**
+ * @brief Settings of a queue owned by a sink
+ */
+struct QueueSettings {
+        /** size of the queue, in bytes */
+        size_t capacity = 4096;
+        /** how often the queue is drained, in milliseconds */
+        uint32_t rate = 50;
+        /** priority of the task that drains the queue */
+        uint32_t priority = TASK_PRIORITY_DEFAULT;
+        /** what to do with messages that don't fit */
+        DropPolicy policy = DropPolicy::DROP_NEWEST;
+        /** bytes of the queue only ERROR and FATAL messages can use */
+        size_t reservedSpace = 512;
+};
+
 /**
  * @brief A base for any sink in LemLib to implement.
  *
@@ -21,6 +50,11 @@ class BaseSink {
     public:
         BaseSink() = default;
 
+        /**
+         * @brief Destroy the sink, once every deferred message logged to it has been sent
+         */
+        virtual ~BaseSink();
+
         /**
          * @brief Construct a new combined sink
          *
@@ -50,6 +84,82 @@ class BaseSink {
          */
         void setLowestLevel(Level level);
 
+        /**
+         * @brief Check whether a message of the given level would be logged
+         * If this is a combined sink, this checks whether any
+         * of the parent sinks would log it.
+         *
+         * Cheap enough to check before computing the arguments of a message. LEMLIB_LOG and the related macros check it
+         * before evaluating any arguments.
+         *
+         * @param level the level of the message
+         * @return true the message would be logged
+         * @return false the message would be ignored
+         */
+        bool isEnabled(Level level) const;
+
+        /**
+         * @brief Set whether messages are formatted later, by a low priority task
+         * If this is a combined sink, this operation will
+         * apply for all the parent sinks.
+         *
+         * Formatting a message allocates strings, which takes time away from the task that logged it. In deferred mode,
+         * logging a message only copies the arguments into a ring, and the formatting is done by a low priority task.
+         * Only messages whose arguments are all numbers, enums, or poses are deferred. Messages with any other
+         * argument, like strings, string views, and pointers, are still formatted immediately. A sink waits for its
+         * messages that are still waiting to be formatted before it is destroyed.
+         *
+         * @param deferred whether messages are deferred. false by default
+         *
+         * <h3> Example Usage </h3>
+         * @code
+         * lemlib::infoSink()->setDeferred(true);
+         * // only copies the float, the message is formatted later
+         * lemlib::infoSink()->debug("Motor power: {}", power);
+         * @endcode
+         */
+        void setDeferred(bool deferred);
+
+        /**
+         * @brief Set the source id of messages logged to the sink
+         * If this is a combined sink, this operation will
+         * apply for all the parent sinks.
+         *
+         * The source tells apart messages from different parts of the program once they are merged into one timeline,
+         * and can be added to the format of the sink with {source}.
+         *
+         * @param source the source id. 0 by default
+         *
+         * <h3> Example Usage </h3>
+         * @code
+         * auto odomSink = std::make_shared<lemlib::FileSink>("/usd/odom");
+         * odomSink->setSource(1);
+         * @endcode
+         */
+        void setSource(uint8_t source);
+
+        /**
+         * @brief Give the sink a queue of its own
+         * If this is a combined sink, this operation will
+         * apply for all the parent sinks, each getting its own queue.
+         *
+         * By default, sinks that print to the terminal share the queue of bufferedStdout(), so a burst of messages on
+         * one sink can delay or push out the messages of every other sink. A sink with its own queue is drained by its
+         * own task, at its own rate, and only drops its own messages. Part of every queue is reserved for ERROR and
+         * FATAL messages, so they get through even when the queue is full of less important ones.
+         *
+         * The capacity and priority can only be set the first time. Should be called before messages are logged.
+         *
+         * @param settings the settings of the queue
+         *
+         * <h3> Example Usage </h3>
+         * @code
+         * // debug messages are drained slowly, and the oldest are dropped when there are too many
+         * debugSink->setQueue({.rate = 100, .priority = TASK_PRIORITY_MIN, .policy = lemlib::DropPolicy::DROP_OLDEST});
+         * @endcode
+         */
+        void setQueue(const QueueSettings& settings);
+
         /**
          * @brief Log a message at the given level
          * If this is a combined sink, this operation will
@@ -72,23 +182,23 @@ class BaseSink {
                 return;
             }
 
-            if (level < lowestLevel) { return; }
+            if (!levelCompiledIn(level) || level < lowestLevel) { return; }
 
-            // substitute the user's arguments into the format.
-            std::string messageString = fmt::format(format, std::forward<T>(args)...);
+            LEMLIB_PROFILE(ProfileSection::LOGGER);
 
-            Message message = Message {.level = level, .time = pros::millis()};
-
-            // get the arguments
-            fmt::dynamic_format_arg_store<fmt::format_context> formattingArgs = getExtraFormattingArgs(message);
-
-            formattingArgs.push_back(fmt::arg("time", message.time));
-            formattingArgs.push_back(fmt::arg("level", message.level));
-            formattingArgs.push_back(fmt::arg("message", messageString));
+            // copy the arguments and leave the formatting to the deferred task, if it can be done safely
+            if constexpr (deferrable<T...>) {
+                if (deferred && pushDeferred<std::decay_t<T>...>(level, format.get(), args...)) return;
+            }
 
-            std::string formattedString = fmt::vformat(logFormat, std::move(formattingArgs));
-            message.message = std::move(formattedString);
-            sendMessage(std::move(message));
+            // substitute the user's arguments into the format, straight into the arena so nothing is allocated
+            const LogArena::Slab text = logArena().acquire();
+            const size_t size = fmt::format_to_n(text.data(), text.capacity(), format, std::forward<T>(args)...).size;
+            const LogArena::Slab line = logArena().acquire();
+            const std::string_view messageString(text.data(), std::min(size, text.capacity()));
+            const Message message = createMessage(level, pros::micros(), nextSequence(), messageString, line);
+            LEMLIB_PROFILE_END();
+            sendMessage(message);
         }
 
         /**
@@ -100,7 +210,7 @@ class BaseSink {
          * @param args
          */
         template <typename... T> void debug(fmt::format_string<T...> format, T&&... args) {
-            log(Level::DEBUG, format, std::forward<T>(args)...);
+            if constexpr (levelCompiledIn(Level::DEBUG)) log(Level::DEBUG, format, std::forward<T>(args)...);
         }
 
         /**
@@ -112,7 +222,7 @@ class BaseSink {
          * @param args
          */
         template <typename... T> void info(fmt::format_string<T...> format, T&&... args) {
-            log(Level::INFO, format, std::forward<T>(args)...);
+            if constexpr (levelCompiledIn(Level::INFO)) log(Level::INFO, format, std::forward<T>(args)...);
         }
 
         /**
@@ -124,7 +234,7 @@ class BaseSink {
          * @param args
          */
         template <typename... T> void warn(fmt::format_string<T...> format, T&&... args) {
-            log(Level::WARN, format, std::forward<T>(args)...);
+            if constexpr (levelCompiledIn(Level::WARN)) log(Level::WARN, format, std::forward<T>(args)...);
         }
 
         /**
@@ -136,7 +246,7 @@ class BaseSink {
          * @param args
          */
         template <typename... T> void error(fmt::format_string<T...> format, T&&... args) {
-            log(Level::ERROR, format, std::forward<T>(args)...);
+            if constexpr (levelCompiledIn(Level::ERROR)) log(Level::ERROR, format, std::forward<T>(args)...);
         }
 
         /**
@@ -148,7 +258,7 @@ class BaseSink {
          * @param args
          */
         template <typename... T> void fatal(fmt::format_string<T...> format, T&&... args) {
-            log(Level::FATAL, format, std::forward<T>(args)...);
+            if constexpr (levelCompiledIn(Level::FATAL)) log(Level::FATAL, format, std::forward<T>(args)...);
         }
     protected:
         /**
@@ -158,6 +268,43 @@ class BaseSink {
          */
         virtual void sendMessage(const Message& message);
 
+        /**
+         * @brief Print formatted text, through the queue of the sink if it has one, or bufferedStdout() if it doesn't
+         *
+         * The text is formatted into the log arena, and truncated if it is longer than a slab.
+         *
+         * @param level the level of the message being printed. ERROR and FATAL messages can use the reserved space
+         * @param format
+         * @param args
+         */
+        template <typename... T> void print(Level level, fmt::format_string<T...> format, T&&... args) {
+            const LogArena::Slab slab = logArena().acquire();
+            const size_t size = fmt::format_to_n(slab.data(), slab.capacity(), format, std::forward<T>(args)...).size;
+            const bool important = level >= Level::ERROR;
+            Buffer& buffer = queue != nullptr ? *queue : bufferedStdout();
+            buffer.pushToBuffer(slab.data(), std::min(size, slab.capacity()), important);
+        }
+
+        /**
+         * @brief Write a batch of text from the queue of the sink. Prints to the terminal unless overridden
+         *
+         * Runs in the task of the queue. Sinks that override it have to call stopQueue() in their destructor, so the
+         * queue isn't drained into a sink that is already gone
+         *
+         * @param batch every string that was waiting in the queue
+         */
+        virtual void writeOutput(const std::string& batch);
+
+        /**
+         * @brief Send every deferred message logged to the sink, then write everything in its queue and stop the task
+         * of the queue
+         *
+         * The deferred task calls sendMessage and the task of the queue calls writeOutput, so sinks that override
+         * either of them have to call this first thing in their destructor, while the derived sink still exists.
+         * Called by the destructor of the base sink too, and does nothing the second time
+         */
+        void stopQueue();
+
         /**
          * @brief Set the format of messages that the sink sends
          *
@@ -166,6 +313,9 @@ class BaseSink {
          * Changing the format of the sink changes the way each logged message looks. The following named formatting
          * specifiers can be used:
          * - {time} The time the message was sent in milliseconds since the program started.
+         * - {micros} The time the message was sent in microseconds since the program started.
+         * - {source} The source id of the sink, set with setSource.
+         * - {sequence} The sequence number of the message, which increases by 1 for every message logged.
          * - {level} The level of the logged message.
          * - {message} The message itself.
          *
@@ -201,9 +351,156 @@ class BaseSink {
          */
         virtual fmt::dynamic_format_arg_store<fmt::format_context> getExtraFormattingArgs(const Message& messageInfo);
     private:
+        /**
+         * @brief Whether an argument of the given type can be formatted later
+         *
+         * The argument is copied byte for byte, so it has to hold its whole value. Being trivially copyable isn't
+         * enough: pointers, and views like std::string_view and std::span, are trivially copyable but refer to memory
+         * that may not exist by the time the message is formatted. Only types known to be plain values are allowed
+         */
+        template <typename T> static constexpr bool deferrableArg =
+            std::is_arithmetic_v<T> || std::is_enum_v<T> || std::is_same_v<T, Pose>;
+
+        /**
+         * @brief Whether a message with arguments of the given types can be formatted later
+         */
+        template <typename... T> static constexpr bool deferrable = (deferrableArg<std::decay_t<T>> && ...);
+
+        /**
+         * @brief Formats the arguments of a deferred message, given the bytes they were copied into. Returns the size
+         * the message would have been if it wasn't truncated to fit the output
+         */
+        using DeferredFormatter = size_t (*)(fmt::string_view format, const char* args, char* output, size_t capacity);
+
+        /**
+         * @brief Start of a deferred message in the deferred ring. Followed by the bytes of each argument, in order,
+         * then the format string
+         */
+        struct DeferredHeader {
+                /** size of the whole record, including the header */
+                uint32_t size;
+                /** the sink the message was logged to. Waits for its deferred messages before it is destroyed */
+                BaseSink* sink;
+                /** formats the arguments. Each set of argument types has its own formatter */
+                DeferredFormatter formatter;
+                /** size of the format string. It is copied in, since fmt::runtime formats can be temporary strings */
+                uint32_t formatSize;
+                Level level;
+                /** the time the message was logged, in microseconds */
+                uint64_t micros;
+                /** the sequence number of the message, taken when it was logged so messages stay in order */
+                uint32_t sequence;
+        };
+
+        /**
+         * @brief Copy a message into the deferred ring
+         *
+         * @return true the message was copied in, or dropped because the ring is full
+         * @return false the message is too long to copy into the arena, and has to be formatted immediately
+         */
+        template <typename... T> bool pushDeferred(Level level, fmt::string_view format, const T&... args) {
+            constexpr size_t argsSize = (sizeof(T) + ... + 0);
+            const size_t size = sizeof(DeferredHeader) + argsSize + format.size();
+            const LogArena::Slab record = logArena().acquire();
+            if (size > record.capacity()) return false;
+            const DeferredHeader header {uint32_t(size), this,           &formatDeferred<T...>,
+                                         uint32_t(format.size()), level, pros::micros(), nextSequence()};
+            std::memcpy(record.data(), &header, sizeof(header));
+            char* position = record.data() + sizeof(header);
+            ((std::memcpy(position, &args, sizeof(T)), position += sizeof(T)), ...);
+            std::memcpy(position, format.data(), format.size());
+            // counted before it is pushed, so the sink can't be destroyed while the deferred task is sending it
+            pendingDeferred++;
+            // errors use the reserved space of the deferred ring, so a burst of less important messages can't drop them
+            if (!deferredBuffer().pushToBuffer(record.data(), size, level >= Level::ERROR)) pendingDeferred--;
+            return true;
+        }
+
+        /**
+         * @brief Format the arguments of a deferred message
+         */
+        template <typename... T>
+        static size_t formatDeferred(fmt::string_view format, const char* args, char* output, size_t capacity) {
+            // braced initializers are evaluated in order, so each argument is read from where the last one ended
+            const std::tuple<T...> values {readDeferred<T>(args)...};
+            return std::apply(
+                [&](const auto&... value) {
+                    return fmt::vformat_to_n(output, capacity, format, fmt::make_format_args(value...)).size;
+                },
+                values);
+        }
+
+        /**
+         * @brief Read an argument of a deferred message, and move past it
+         */
+        template <typename T> static T readDeferred(const char*& position) {
+            std::array<char, sizeof(T)> bytes;
+            std::memcpy(bytes.data(), position, sizeof(T));
+            position += sizeof(T);
+            return std::bit_cast<T>(bytes);
+        }
+
+        /**
+         * @brief Format and send every deferred message in a batch from the deferred ring
+         */
+        static void sendDeferred(const std::string& batch);
+
+        /**
+         * @brief Get the ring deferred messages are copied into. Shared by all sinks
+         */
+        static Buffer& deferredBuffer();
+
+        /**
+         * @brief Wait until every deferred message logged to the sink has been sent
+         */
+        void flushDeferred();
+
+        /**
+         * @brief Substitute a message into the format of the sink
+         *
+         * @param level the level of the message
+         * @param micros the time the message was logged, in microseconds
+         * @param sequence the sequence number of the message
+         * @param messageString the message, with the user's arguments already substituted in
+         * @param line the slab to format the message into. Must outlive the message
+         * @return Message the formatted message
+         */
+        Message createMessage(Level level, uint64_t micros, uint32_t sequence, std::string_view messageString,
+                              const LogArena::Slab& line);
+
         Level lowestLevel = Level::WARN;
+        bool deferred = false;
+        // deferred messages of the sink that haven't been sent yet
+        std::atomic<uint32_t> pendingDeferred = 0;
+        uint8_t source = 0;
+        // the queue the sink prints through. nullptr if it prints through bufferedStdout()
+        std::unique_ptr<Buffer> queue;
         std::string logFormat;
 
         std::vector<std::shared_ptr<BaseSink>> sinks {};
 };
 } // namespace lemlib
+
+/**
+ * log a message to a sink, without evaluating the arguments unless the message will be logged. Removed entirely if
+ * the level is below LEMLIB_MIN_LOG_LEVEL
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * // expensiveDump() is only called if the info sink logs debug messages
+ * LEMLIB_LOG(lemlib::infoSink(), lemlib::Level::DEBUG, "state: {}", expensiveDump());
+ * @endcode
+ */
+#define LEMLIB_LOG(sink, level, ...)                                                                                   \
+    do {                                                                                                               \
+        if constexpr (lemlib::levelCompiledIn(level)) {                                                                \
+            auto&& lemlibLogSink = (sink);                                                                             \
+            if (lemlibLogSink->isEnabled(level)) lemlibLogSink->log(level, __VA_ARGS__);                               \
+        }                                                                                                              \
+    } while (0)
+/** log a debug message with LEMLIB_LOG */
+#define LEMLIB_DEBUG(sink, ...) LEMLIB_LOG(sink, lemlib::Level::DEBUG, __VA_ARGS__)
+/** log an info message with LEMLIB_LOG */
+#define LEMLIB_INFO(sink, ...) LEMLIB_LOG(sink, lemlib::Level::INFO, __VA_ARGS__)
+/** log a warning with LEMLIB_LOG */
+#define LEMLIB_WARN(sink, ...) LEMLIB_LOG(sink, lemlib::Level::WARN, __VA_ARGS__)
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "lemlib/logger/buffer.hpp"
+
+namespace lemlib {
+/**
+ * @brief Channels LemLib sends telemetry on
+ *
+ * Channels added with BinaryTelemetry::addChannel are numbered after these
+ */
+enum class TelemetryChannel : uint8_t {
+    POSE, /** x and y in inches, theta in degrees. Sent by odometry */
+    VELOCITY, /** local speed of the robot. Forwards in inches per second, turning in degrees per second */
+    MOTOR_POWER, /** power sent to the left and right sides of the drivetrain, out of 127 */
+    CONTROLLER_ERROR /** lateral error in inches and angular error in degrees of the running motion */
+};
+
+/**
+ * @brief Type of a frame of binary telemetry
+ */
+enum class FrameType : uint8_t {
+    SCHEMA, /** the name and field names of a channel */
+    SAMPLE /** a sample of every field of a channel */
+};
+
+/**
+ * @brief Binary telemetry
+ *
+ * Sends samples of numeric channels over stdout in a compact binary format, for a computer to record. Each channel has
+ * a name and a list of fields, described by a schema frame that is resent every second, so a decoder can attach at any
+ * time. A sample of a channel is a 1 byte channel id, a 2 byte sequence number, a 4 byte timestamp in microseconds, and
+ * a 4 byte float per field. The timestamp wraps around every 71 minutes, which the decoder undoes, and the sequence
+ * number increases by 1 for every sample sent on any channel, so the decoder can count samples that were lost.
+ *
+ * Each frame ends with a CRC-8, and is COBS encoded and terminated by a 0 byte, so the decoder can find the start of
+ * every frame and discard frames that were corrupted or interleaved with text printed to the terminal. Use
+ * sim/build/decode to turn a capture of the stream into CSV.
+ *
+ * Telemetry is disabled by default.
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * // send the pose every 50 ms instead of every 10 ms
+ * lemlib::binaryTelemetry().setDecimation(lemlib::TelemetryChannel::POSE, 5);
+ * // send a custom channel
+ * const uint8_t lift = lemlib::binaryTelemetry().addChannel("lift", {"position", "current"});
+ * lemlib::binaryTelemetry().setEnabled(true);
+ * lemlib::binaryTelemetry().send(lift, {liftMotor.get_position(), liftMotor.get_current_draw()});
+ * @endcode
+ */
+class BinaryTelemetry {
+    public:
+        /**
+         * @brief Construct a new Binary Telemetry object, with the channels LemLib sends on
+         */
+        BinaryTelemetry();
+
+        /**
+         * @brief Add a channel
+         *
+         * Channels should be added before telemetry is enabled
+         *
+         * @param name name of the channel
+         * @param fields names of the fields in each sample
+         * @param decimation only send every nth sample. 1 by default
+         * @return uint8_t id of the channel, or 255 if there are no channels left or there are too many fields
+         */
+        uint8_t addChannel(const std::string& name, std::initializer_list<std::string> fields, uint32_t decimation = 1);
+
+        /**
+         * @brief Set how many samples of a channel are skipped for every sample sent
+         *
+         * @param channel id of the channel
+         * @param decimation only send every nth sample. 1 sends every sample
+         */
+        void setDecimation(uint8_t channel, uint32_t decimation);
+
+        /**
+         * @brief Set how many samples of a channel are skipped for every sample sent
+         *
+         * @param channel the channel
+         * @param decimation only send every nth sample. 1 sends every sample
+         */
+        void setDecimation(TelemetryChannel channel, uint32_t decimation);
+
+        /**
+         * @brief Set whether telemetry is sent
+         *
+         * @param enabled whether telemetry is sent. false by default
+         */
+        void setEnabled(bool enabled);
+
+        /**
+         * @brief Check whether telemetry is sent
+         */
+        bool isEnabled() const;
+
+        /**
+         * @brief Send a sample of a channel
+         *
+         * Does nothing if telemetry is disabled, or the sample is skipped by decimation. Missing fields are sent as 0,
+         * and extra values are ignored
+         *
+         * @param channel id of the channel
+         * @param values the value of each field
+         */
+        void send(uint8_t channel, std::initializer_list<float> values);
+
+        /**
+         * @brief Send a sample of a channel
+         *
+         * @param channel the channel
+         * @param values the value of each field
+         */
+        void send(TelemetryChannel channel, std::initializer_list<float> values);
+
+        /**
+         * @brief Get the number of frames that were dropped because the buffer was full
+         */
+        uint32_t getDropped() const;
+
+        /** most channels that can be added, including the ones LemLib sends on */
+        static constexpr uint8_t MAX_CHANNELS = 32;
+        /** most fields a channel can have */
+        static constexpr uint8_t MAX_FIELDS = 16;
+        /** channel id returned when a channel can't be added */
+        static constexpr uint8_t INVALID_CHANNEL = 255;
+    private:
+        struct Channel {
+                std::string name;
+                std::vector<std::string> fields;
+                std::atomic<uint32_t> decimation = 1;
+                std::atomic<uint32_t> count = 0;
+        };
+
+        /**
+         * @brief COBS encode a frame, append its delimiter, and push it to the buffer
+         *
+         * @param frame the frame, with its CRC already appended
+         * @param size size of the frame
+         */
+        void pushFrame(const uint8_t* frame, size_t size);
+
+        /**
+         * @brief Send the schema of every channel
+         */
+        void sendSchemas();
+
+        std::array<Channel, MAX_CHANNELS> channels;
+        std::atomic<uint8_t> channelCount = 0;
+        std::atomic<bool> enabled = false;
+        std::atomic<uint32_t> lastSchemaTime = 0;
+        std::atomic<bool> schemaSent = false;
+        std::atomic<uint16_t> sequence = 0;
+
+        Buffer buffer;
+};
+
+/**
+ * @brief Get the binary telemetry
+ *
+ */
+BinaryTelemetry& binaryTelemetry();
+
+/**
+ * @brief Calculate the CRC-8 of some bytes, with the polynomial 0x07
+ *
+ * @param data the bytes
+ * @param size number of bytes
+ * @return uint8_t the CRC
+ */
+uint8_t crc8(const uint8_t* data, size_t size);
+
+/**
+ * @brief COBS encode bytes, so the output contains no 0 bytes
+ *
+ * @param data the bytes to encode
+ * @param size number of bytes
+ * @param output where to write the encoded bytes. Must have space for size + size / 254 + 1 bytes
+ * @return size_t number of bytes written
+ */
+size_t cobsEncode(const uint8_t* data, size_t size, uint8_t* output);
+
+/**
+ * @brief Decode COBS encoded bytes
+ *
+ * @param data the encoded bytes, not including the 0 delimiter
+ * @param size number of bytes
+ * @return std::optional<std::vector<uint8_t>> the decoded bytes, or nothing if the bytes aren't valid COBS
+ */
+std::optional<std::vector<uint8_t>> cobsDecode(const uint8_t* data, size_t size);
+} // namespace lemlib
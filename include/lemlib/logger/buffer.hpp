@@ -1,28 +1,50 @@
 #pragma once
 
-#include <deque>
+#include <atomic>
 #include <functional>
+#include <memory>
 #include <string>
 
 #include "pros/rtos.hpp"
 
 namespace lemlib {
+/**
+ * @brief What a buffer does with a string that doesn't fit
+ */
+enum class DropPolicy {
+    DROP_NEWEST, /** discard the string that doesn't fit. Pushing never waits */
+    DROP_OLDEST, /** discard the oldest strings until the string fits. Pushing may wait briefly for the buffer's task */
+    BLOCK /** wait until the buffer has drained enough for the string to fit */
+};
+
 /**
  * @brief A buffer implementation
  *
- * Asynchronously processes a backlog of strings at a given rate. The strings are processed in a first in last out
+ * Asynchronously processes a backlog of strings at a given rate. The strings are processed in a first in first out
  * order.
+ *
+ * The strings are stored in a preallocated ring of bytes, so the memory used by the buffer doesn't grow no matter how
+ * fast strings are pushed. Any number of tasks can push to the buffer without locking. Every time the buffer's task
+ * wakes up, it processes all the strings that are waiting in a single batch.
+ *
+ * Part of the ring can be reserved for important strings, like errors, so they still fit when the rest of the ring is
+ * full of less important ones.
  */
 class Buffer {
     public:
         /**
          * @brief Construct a new Buffer object
          *
+         * @param bufferFunc the function to apply to each batch of strings
+         * @param capacity size of the ring, in bytes. Rounded up to a power of 2. 4096 by default
+         * @param policy what to do with a string that doesn't fit. DROP_NEWEST by default
+         * @param priority priority of the buffer's task. TASK_PRIORITY_DEFAULT by default
          */
-        Buffer(std::function<void(const std::string&)> bufferFunc);
+        Buffer(std::function<void(const std::string&)> bufferFunc, size_t capacity = 4096,
+               DropPolicy policy = DropPolicy::DROP_NEWEST, std::uint32_t priority = TASK_PRIORITY_DEFAULT);
 
         /**
-         * @brief Destroy the Buffer object
+         * @brief Destroy the Buffer object, once every string has been processed and the task has stopped
          *
          */
         ~Buffer();
@@ -34,8 +56,23 @@ class Buffer {
          * @brief Push to the buffer
          *
          * @param bufferData
+         * @return true the string was added to the buffer
+         * @return false the string was dropped
          */
-        void pushToBuffer(const std::string& bufferData);
+        bool pushToBuffer(const std::string& bufferData);
+
+        /**
+         * @brief Push bytes to the buffer
+         *
+         * The bytes are copied into the buffer as a single record, so they are never split between batches
+         *
+         * @param data pointer to the bytes
+         * @param size number of bytes
+         * @param important whether the bytes can use the reserved space. false by default
+         * @return true the bytes were added to the buffer
+         * @return false the bytes were dropped
+         */
+        bool pushToBuffer(const char* data, size_t size, bool important = false);
 
         /**
          * @brief Set the rate of the sink
@@ -44,6 +81,27 @@ class Buffer {
          */
         void setRate(uint32_t rate);
 
+        /**
+         * @brief Set what the buffer does with strings that don't fit
+         *
+         * @param policy the drop policy
+         */
+        void setDropPolicy(DropPolicy policy);
+
+        /**
+         * @brief Set how much of the ring only important strings can use
+         *
+         * @param bytes size of the reserved space, in bytes. 0 by default
+         */
+        void setReservedSpace(size_t bytes);
+
+        /**
+         * @brief Get the number of strings that were dropped because the buffer was full
+         *
+         * @return uint32_t number of dropped strings
+         */
+        uint32_t getDropped() const;
+
         /**
          * @brief Check to see if the internal buffer is empty
          *
@@ -57,16 +115,71 @@ class Buffer {
         void taskLoop();
 
         /**
-         * @brief The function that will be applied to each string in the buffer when it is removed.
+         * @brief Move every string that has been pushed into the batch
+         */
+        void drain();
+
+        /**
+         * @brief Discard the oldest string, to make space for a new one
          *
+         * @param important whether the new string is important. Only important strings can discard important strings
+         * @return true a string was discarded
+         * @return false there was no string that could be discarded
          */
-        std::function<void(std::string)> bufferFunc;
+        bool discardOldest(bool important);
 
-        std::deque<std::string> buffer = {};
+        /**
+         * @brief Get the word of the ring at a position
+         *
+         * @param position position in the ring, in bytes. Must be a multiple of the word size
+         * @return uint32_t& the word
+         */
+        uint32_t& wordAt(uint32_t position);
 
-        pros::Mutex mutex;
-        pros::Task task;
+        /**
+         * @brief Copy bytes into the ring, wrapping around the end if needed
+         *
+         * @param position position in the ring to start copying to
+         * @param source bytes to copy
+         * @param size number of bytes to copy
+         */
+        void copyIn(uint32_t position, const char* source, uint32_t size);
+
+        /**
+         * @brief Append bytes from the ring to the batch, wrapping around the end if needed
+         *
+         * @param position position in the ring to start copying from
+         * @param size number of bytes to copy
+         */
+        void copyOut(uint32_t position, uint32_t size);
 
-        uint32_t rate;
+        /**
+         * @brief The function that will be applied to each batch of strings when they are removed.
+         *
+         */
+        std::function<void(const std::string&)> bufferFunc;
+
+        // the ring is made of words so the header at the start of each record can be accessed atomically
+        // a header holds the length of the string plus 1, and stays 0 until the string has been copied in. The top bit
+        // is set if the string is important
+        uint32_t capacity;
+        std::unique_ptr<uint32_t[]> ring;
+        // strings removed from the ring, waiting to be processed. Preallocated to the size of the ring
+        std::string batch;
+
+        // positions in bytes. They only ever increase, and are wrapped when indexing into the ring
+        std::atomic<uint32_t> head = 0; // end of the space reserved by producers
+        std::atomic<uint32_t> tail = 0; // start of the space not yet drained
+        std::atomic<uint32_t> dropped = 0;
+        std::atomic<DropPolicy> policy;
+        std::atomic<uint32_t> reservedSpace = 0;
+        // held while draining, and while discarding the oldest string, since both move the tail
+        pros::Mutex tailMutex;
+
+        std::atomic<uint32_t> rate = 50;
+        std::atomic<bool> closing = false;
+        std::atomic<bool> taskDone = false;
+
+        pros::Task task;
 };
 } // namespace lemlib
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "pros/rtos.hpp"
+#include "lemlib/logger/baseSink.hpp"
+
+namespace lemlib {
+/**
+ * @brief Sink for writing messages to files on the SD card
+ *
+ * Messages are copied into one of two segment buffers. When a segment is full, or has held messages for a second, it
+ * is handed off to a low priority task that writes it to the SD card while the other segment fills up, so logging never
+ * waits for the SD card. If both segments are full, messages are dropped until one is written.
+ *
+ * Each segment is written with a header holding the times of its first and last message, optionally compressed with
+ * LZ4, and padded to a multiple of 512 bytes. When a file gets too big, the sink moves on to the next one:
+ * prefix_000.log, prefix_001.log, and so on. Files left by an earlier run are never overwritten. Next to each file is
+ * an index, prefix_000.idx, with the offset and times of each segment, so sim/build/logcat can find the messages logged
+ * at a time without reading the whole file.
+ *
+ * Raw records, like binary telemetry frames, can be written with write(). They should go to a sink of their own, so
+ * they aren't mixed with text.
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * const auto file = std::make_shared<lemlib::FileSink>("/usd/match");
+ * file->setLowestLevel(lemlib::Level::INFO);
+ * file->info("autonomous started");
+ * // send messages to the terminal and the SD card
+ * lemlib::BaseSink sink({lemlib::infoSink(), file});
+ * sink.warn("low battery");
+ * @endcode
+ */
+class FileSink : public BaseSink {
+    public:
+        /**
+         * @brief Construct a new File Sink
+         *
+         * @param prefix path of the files, without the number and extension. "/usd/lemlib" by default
+         * @param segmentSize size of each segment buffer in bytes, rounded up to a multiple of 512. 16 KiB by default
+         * @param compress whether to compress segments with LZ4. false by default
+         * @param maxFileSize size in bytes a file can grow to before moving on to the next one. 4 MiB by default
+         */
+        FileSink(const std::string& prefix = "/usd/lemlib", size_t segmentSize = 16384, bool compress = false,
+                 size_t maxFileSize = 4 * 1024 * 1024);
+
+        /**
+         * @brief Destroy the File Sink, writing every message that has been logged
+         */
+        ~FileSink();
+
+        FileSink(const FileSink&) = delete;
+        FileSink& operator=(const FileSink&) = delete;
+
+        /**
+         * @brief Write a raw record, like a binary telemetry frame
+         *
+         * @param data the record
+         * @param size size of the record. Records bigger than a segment are dropped
+         * @return true the record was copied into a segment
+         * @return false the record was dropped
+         */
+        bool write(const char* data, size_t size);
+
+        /**
+         * @brief Hand off the current segment, and wait until every logged message has been written
+         */
+        void flush();
+
+        /**
+         * @brief Get the number of records that were dropped because both segments were full or a file couldn't be
+         * written
+         */
+        uint32_t getDropped() const;
+
+        /** segments are padded to a multiple of this many bytes */
+        static constexpr size_t ALIGNMENT = 512;
+    private:
+        /**
+         * @brief Log the given message
+         *
+         * @param message
+         */
+        void sendMessage(const Message& message) override;
+
+        /**
+         * @brief Copy a record into the active segment, handing it off if it is full
+         *
+         * @param newline whether to end the record with a newline
+         */
+        bool append(const char* data, size_t size, uint32_t time, bool newline = false);
+
+        /**
+         * @brief Hand off the active segment to the task, if the other segment is free. The mutex must be held
+         *
+         * @return true the segment was handed off
+         */
+        bool handOff();
+
+        /**
+         * @brief Hand off segments that have held messages for too long, and write handed off segments
+         */
+        void taskLoop();
+
+        /**
+         * @brief Write the handed off segment, moving on to the next file first if needed. Runs in the background task
+         */
+        void writeSegment();
+
+        /**
+         * @brief Open the next file that doesn't exist yet, and its index
+         */
+        bool openFile();
+
+        struct Segment {
+                std::vector<char> data;
+                size_t used = 0;
+                uint32_t records = 0;
+                uint32_t firstTime = 0;
+                uint32_t lastTime = 0;
+        };
+
+        const std::string prefix;
+        const size_t segmentSize;
+        const bool compress;
+        const size_t maxFileSize;
+
+        // messages are copied into the active segment. The other segment is either free or handed off to the task
+        std::array<Segment, 2> segments;
+        uint8_t active = 0;
+        std::atomic<bool> handedOff = false;
+        pros::Mutex mutex;
+        // where segments are compressed to, and the table used to compress them. Only used by the task
+        std::vector<uint8_t> compressed;
+        std::vector<uint32_t> matchTable;
+
+        FILE* file = nullptr;
+        FILE* index = nullptr;
+        size_t fileSize = 0;
+        int fileNumber = 0;
+
+        std::atomic<uint32_t> dropped = 0;
+        std::atomic<bool> flushRequested = false;
+        std::atomic<bool> closing = false;
+        std::atomic<bool> taskDone = false;
+        pros::Task* task = nullptr;
+};
+} // namespace lemlib
@@ -25,6 +25,11 @@ class InfoSink : public BaseSink {
          * @brief Construct a new Info Sink object
          */
         InfoSink();
+
+        /**
+         * @brief Destroy the Info Sink, once its deferred and queued messages have been written
+         */
+        ~InfoSink();
     private:
         /**
          * @brief Log the given message
@@ -6,9 +6,13 @@
 #define FMT_HEADER_ONLY
 #include "fmt/core.h"
 
+#include "lemlib/logger/arena.hpp"
 #include "lemlib/logger/baseSink.hpp"
 #include "lemlib/logger/infoSink.hpp"
 #include "lemlib/logger/telemetrySink.hpp"
+#include "lemlib/logger/binaryTelemetry.hpp"
+#include "lemlib/logger/recorder.hpp"
+#include "lemlib/logger/fileSink.hpp"
 
 namespace lemlib {
 
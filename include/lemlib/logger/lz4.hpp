@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace lemlib {
+/**
+ * @brief Get the most bytes LZ4 compressing some bytes can produce
+ *
+ * @param size number of bytes to compress
+ * @return size_t the size of the largest possible output
+ */
+constexpr size_t lz4CompressBound(size_t size) { return size + size / 255 + 16; }
+
+/** number of entries in the hash table used to find matches while compressing */
+constexpr size_t LZ4_TABLE_SIZE = 1 << 12;
+
+/**
+ * @brief Compress bytes into an LZ4 block
+ *
+ * The output is in the standard LZ4 block format, so it can be decompressed with any LZ4 implementation. Compression
+ * is greedy, which is fast but doesn't compress quite as well as the reference implementation.
+ *
+ * @param data the bytes to compress
+ * @param size number of bytes
+ * @param output where to write the compressed block
+ * @param capacity size of the output. lz4CompressBound(size) is always enough
+ * @param table LZ4_TABLE_SIZE entries to find matches with. Passed in so it can be reused, and compressing doesn't
+ * allocate. Its contents don't matter, it is cleared before use
+ * @return size_t size of the compressed block, or 0 if it didn't fit in the output
+ */
+size_t lz4Compress(const uint8_t* data, size_t size, uint8_t* output, size_t capacity, uint32_t* table);
+
+/**
+ * @brief Decompress an LZ4 block
+ *
+ * @param data the compressed block
+ * @param size size of the compressed block
+ * @param decompressedSize size of the data before it was compressed
+ * @return std::optional<std::vector<uint8_t>> the decompressed bytes, or nothing if the block is invalid
+ */
+std::optional<std::vector<uint8_t>> lz4Decompress(const uint8_t* data, size_t size, size_t decompressedSize);
+} // namespace lemlib
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <cstdint>
 
 namespace lemlib {
@@ -10,21 +11,54 @@ namespace lemlib {
  */
 enum class Level { INFO, DEBUG, WARN, ERROR, FATAL };
 
+#ifndef LEMLIB_MIN_LOG_LEVEL
+/**
+ * messages below this level are removed at compile time when logged with LEMLIB_LOG and the related macros. Can be
+ * set when compiling, for example -DLEMLIB_MIN_LOG_LEVEL=lemlib::Level::WARN for competition builds
+ */
+#define LEMLIB_MIN_LOG_LEVEL lemlib::Level::INFO
+#endif
+
+/**
+ * @brief Whether messages of a level are compiled in
+ *
+ * @param level the level
+ * @return true messages of the level are compiled in
+ * @return false messages of the level are removed at compile time
+ */
+constexpr bool levelCompiledIn(Level level) { return level >= LEMLIB_MIN_LOG_LEVEL; }
+
 /**
  * @brief A loggable message
  *
  */
 struct Message {
-        /* The message */
-        std::string message;
+        /* The message. Formatted into the log arena, so it is only valid until the sink has sent it */
+        std::string_view message;
 
         /** The level of the message */
         Level level;
 
         /** The time the message was logged, in milliseconds */
         uint32_t time;
+
+        /** The time the message was logged, in microseconds. Precise enough to order messages within a control tick */
+        uint64_t micros;
+
+        /** The source of the message, set with BaseSink::setSource */
+        uint8_t source;
+
+        /** The sequence number of the message. Increases by 1 for every message logged by the program, in any sink */
+        uint32_t sequence;
 };
 
+/**
+ * @brief Get the sequence number of the next message, and advance it
+ *
+ * @return uint32_t the sequence number
+ */
+uint32_t nextSequence();
+
 /**
  * @brief Format a level
  *
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "pros/rtos.hpp"
+
+namespace lemlib {
+/**
+ * @brief Records many signals every control tick, for analysis after a match
+ *
+ * Channels are registered once, before recording starts. Samples are stored column by column in preallocated blocks:
+ * a block holds a fixed number of rows, with all the timestamps, then all the samples of the first channel, then the
+ * second, and so on. Recording a sample is a single store, and a tick is an index increment, so hundreds of samples can
+ * be recorded every tick without slowing down the control loop.
+ *
+ * When a block is full, a background task writes it to a file on the SD card, or to the terminal. If every block is
+ * waiting to be written, ticks are dropped until one is free. Recordings can be turned into CSV with
+ * sim/build/decode.
+ *
+ * Samples should be recorded from a single task. A channel that isn't recorded on a tick is NaN for that tick.
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * lemlib::TelemetryRecorder recorder;
+ * const uint16_t x = recorder.addChannel("x");
+ * const uint16_t current = recorder.addChannel("left_current");
+ * recorder.start("/usd/match.bin");
+ * while (true) {
+ *     recorder.record(x, chassis.getPose().x);
+ *     recorder.record(current, leftMotors.get_current_draw());
+ *     recorder.tick();
+ *     pros::delay(10);
+ * }
+ * @endcode
+ */
+class TelemetryRecorder {
+    public:
+        /**
+         * @brief Construct a new Telemetry Recorder
+         *
+         * @param rowsPerBlock number of ticks in each block. 128 by default
+         * @param blocks number of blocks. 4 by default
+         */
+        TelemetryRecorder(uint16_t rowsPerBlock = 128, uint8_t blocks = 4);
+
+        /**
+         * @brief Destroy the Telemetry Recorder, writing anything that has been recorded
+         */
+        ~TelemetryRecorder();
+
+        TelemetryRecorder(const TelemetryRecorder&) = delete;
+        TelemetryRecorder& operator=(const TelemetryRecorder&) = delete;
+
+        /**
+         * @brief Add a channel. Channels can only be added before recording starts
+         *
+         * @param name name of the channel
+         * @return uint16_t id of the channel, used to record samples
+         */
+        uint16_t addChannel(const std::string& name);
+
+        /**
+         * @brief Start recording
+         *
+         * Allocates the blocks, and writes the names of the channels to the output
+         *
+         * @param path path of the file to write to, for example "/usd/match.bin". Writes to the terminal if empty
+         * @return true recording started
+         * @return false the file couldn't be opened, or the recorder is already recording
+         */
+        bool start(const std::string& path = "");
+
+        /**
+         * @brief Stop recording, and wait until every recorded tick has been written
+         */
+        void stop();
+
+        /**
+         * @brief Record a sample of a channel for the current tick
+         *
+         * @param channel id of the channel
+         * @param value the sample
+         */
+        void record(uint16_t channel, float value) {
+            if (row != nullptr && channel < channelCount) row[size_t(channel + 1) * rowsPerBlock] = value;
+        }
+
+        /**
+         * @brief Finish the current tick, and start the next one
+         */
+        void tick();
+
+        /**
+         * @brief Get the number of ticks that were dropped because every block was waiting to be written
+         */
+        uint32_t getDropped() const;
+    private:
+        /**
+         * @brief Start filling the next block, if one is free
+         */
+        void nextBlock();
+
+        /**
+         * @brief Write every full block to the output. Runs in the background task
+         */
+        void flush();
+
+        /**
+         * @brief Get the start of a block
+         */
+        float* blockData(uint32_t block);
+
+        const uint16_t rowsPerBlock;
+        const uint8_t blocks;
+        std::vector<std::string> names;
+        uint16_t channelCount = 0;
+
+        // each block has a column for the timestamps, then one for each channel
+        std::vector<float> data;
+        // rows in each block. Only less than rowsPerBlock for the last block of a recording
+        std::vector<uint16_t> rows;
+        // blocks are filled and written in order. Both counts only ever increase
+        std::atomic<uint32_t> filled = 0;
+        std::atomic<uint32_t> written = 0;
+
+        // the current row of the current block, offset so the timestamp is at index 0 and each channel is a column
+        // after it. nullptr if there is no free block to record into
+        float* row = nullptr;
+        uint16_t rowIndex = 0;
+
+        std::atomic<uint32_t> dropped = 0;
+        std::atomic<bool> recording = false;
+        FILE* output = nullptr;
+
+        // the background task is started by the first recording, and stopped by the destructor
+        pros::Task* task = nullptr;
+        std::atomic<bool> closing = false;
+        std::atomic<bool> taskDone = false;
+};
+} // namespace lemlib
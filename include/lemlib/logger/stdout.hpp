@@ -3,6 +3,7 @@
 #define FMT_HEADER_ONLY
 #include "fmt/core.h"
 
+#include "lemlib/logger/arena.hpp"
 #include "lemlib/logger/buffer.hpp"
 
 namespace lemlib {
@@ -20,9 +21,12 @@ class BufferedStdout : public Buffer {
         /**
          * @brief Print a string (thread-safe).
          *
+         * The string is formatted into the log arena, and truncated if it is longer than a slab.
          */
         template <typename... T> void print(fmt::format_string<T...> format, T&&... args) {
-            pushToBuffer(fmt::format(format, std::forward<T>(args)...));
+            const LogArena::Slab slab = logArena().acquire();
+            const size_t size = fmt::format_to_n(slab.data(), slab.capacity(), format, std::forward<T>(args)...).size;
+            pushToBuffer(slab.data(), std::min(size, slab.capacity()));
         }
 };
 
@@ -23,6 +23,11 @@ class TelemetrySink : public BaseSink {
          * @brief Construct a new Telemetry Sink object
          */
         TelemetrySink();
+
+        /**
+         * @brief Destroy the Telemetry Sink, once its deferred and queued messages have been written
+         */
+        ~TelemetrySink();
     private:
         /**
          * @brief Log the given message
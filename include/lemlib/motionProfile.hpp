@@ -0,0 +1,82 @@
+#pragma once
+
+namespace lemlib {
+/**
+ * @brief The desired state of the robot at a point in time along a motion profile
+ */
+struct ProfileState {
+        /** distance from the start of the profile */
+        float position = 0;
+        /** velocity along the profile */
+        float velocity = 0;
+        /** acceleration along the profile */
+        float acceleration = 0;
+};
+
+/**
+ * @brief Straight line velocity profile that starts and ends at rest
+ *
+ * The profile is trapezoidal if the jerk limit is 0, and an S-curve otherwise. If the distance is too short to reach
+ * the max velocity, the peak velocity is lowered so the profile still starts and ends at rest.
+ * Units are up to the user, as long as they are consistent. LemLib uses inches and seconds.
+ */
+class MotionProfile {
+    public:
+        /**
+         * @brief Plan a new motion profile
+         *
+         * @param distance distance to travel. Must be positive
+         * @param maxVelocity maximum velocity
+         * @param maxAccel maximum acceleration and deceleration
+         * @param maxJerk maximum jerk. 0 for a trapezoidal profile. 0 by default
+         *
+         * @b Example
+         * @code {.cpp}
+         * // travel 24 inches at up to 60 in/s, accelerating at up to 120 in/s^2
+         * lemlib::MotionProfile profile(24, 60, 120);
+         * // get where the robot should be after 0.25 seconds
+         * lemlib::ProfileState state = profile.sample(0.25);
+         * @endcode
+         */
+        MotionProfile(float distance, float maxVelocity, float maxAccel, float maxJerk = 0);
+        /**
+         * @brief Get the desired state at a point in time
+         *
+         * @param time time since the start of the profile. Times past the end return the final state
+         * @return ProfileState the desired state
+         */
+        ProfileState sample(float time) const;
+        /**
+         * @brief Get how long the profile takes to complete
+         *
+         * @return float total duration
+         */
+        float getDuration() const;
+        /**
+         * @brief Get the highest velocity reached by the profile
+         *
+         * @return float peak velocity
+         */
+        float getPeakVelocity() const;
+    private:
+        /**
+         * @brief Get the state during the acceleration phase
+         *
+         * The deceleration phase is a mirror image of the acceleration phase
+         *
+         * @param time time since the start of the acceleration phase
+         * @return ProfileState the desired state
+         */
+        ProfileState sampleAccel(float time) const;
+
+        float distance;
+        float jerk;
+        float peakVelocity = 0;
+        float peakAccel = 0;
+        float jerkTime = 0; // duration of each jerk limited section
+        float constAccelTime = 0; // duration of the constant acceleration section
+        float accelTime = 0; // duration of the whole acceleration phase
+        float accelDistance = 0; // distance traveled during the acceleration phase
+        float cruiseTime = 0; // duration of the constant velocity phase
+};
+} // namespace lemlib
@@ -1,6 +1,14 @@
 #pragma once
 
+#include <optional>
+
 namespace lemlib {
+/**
+ * @brief PID controller
+ *
+ * Gains are in units of a 10 ms update period, the period of the chassis control loop. Updating with the time since
+ * the last update scales the integral and derivative terms, so gains tuned at 10 ms behave the same at any other period
+ */
 class PID {
     public:
         /**
@@ -42,6 +50,76 @@ class PID {
          * @endcode
          */
         float update(float error);
+        /**
+         * @brief Update the PID, given the time since the last update
+         *
+         * @param error target minus position - AKA error
+         * @param dt time since the last update, in milliseconds
+         * @param measurement the measured position. Only used if the derivative is taken on the measurement
+         * @return float output
+         *
+         * @b Example
+         * @code {.cpp}
+         * void opcontrol() {
+         *     // create a PID
+         *     PID pid(5, 0, 20);
+         *     // take the derivative on the measurement, so changing the target doesn't cause a spike
+         *     pid.setDerivativeOnMeasurement(true);
+         *     // update the PID every 5ms
+         *     while (true) {
+         *         const float position = sensor.get_position();
+         *         const float output = pid.update(target - position, 5, position);
+         *         pros::delay(5);
+         *     }
+         * }
+         * @endcode
+         */
+        float update(float error, float dt, std::optional<float> measurement = std::nullopt);
+        /**
+         * @brief Set the time constant of the low pass filter on the derivative
+         *
+         * Differentiating amplifies sensor noise, which the filter smooths out at the cost of a bit of lag
+         *
+         * @param timeConstant time constant, in milliseconds. 0 disables the filter, which is the default
+         *
+         * @b Example
+         * @code {.cpp}
+         * // filter out noise faster than about 20ms
+         * pid.setDerivativeFilter(20);
+         * @endcode
+         */
+        void setDerivativeFilter(float timeConstant);
+        /**
+         * @brief Set whether the derivative is taken on the measurement instead of the error
+         *
+         * The derivative of the measurement doesn't change when the target does, so the derivative term doesn't
+         * spike when the target changes. The measurement has to be passed to update, otherwise the error is used
+         *
+         * @param enabled whether to take the derivative on the measurement. False by default
+         *
+         * @b Example
+         * @code {.cpp}
+         * pid.setDerivativeOnMeasurement(true);
+         * @endcode
+         */
+        void setDerivativeOnMeasurement(bool enabled);
+        /**
+         * @brief Limit the output of the PID, with back-calculation anti windup
+         *
+         * While the output is limited, the integral is driven back by the difference between the limited and
+         * unlimited output, so it doesn't wind up while the output can't increase anyway
+         *
+         * @param limit the maximum magnitude of the output. 0 disables the limit, which is the default
+         * @param trackingGain how fast the integral is corrected, as a fraction of the difference per 10 ms. 1 by
+         * default
+         *
+         * @b Example
+         * @code {.cpp}
+         * // the motors can't take more than 127
+         * pid.setOutputLimit(127);
+         * @endcode
+         */
+        void setOutputLimit(float limit, float trackingGain = 1);
 
         /**
          * @brief reset integral, derivative, and prevTime
@@ -60,17 +138,59 @@ class PID {
          * @endcode
          */
         void reset();
+
+        /**
+         * @brief Reset the PID as if its last update had the given error
+         *
+         * The first update after this doesn't see a jump from an error of 0, so it doesn't produce a derivative kick.
+         * Used when the PID takes over from something that was already controlling the system
+         *
+         * @param error the error the PID starts from
+         *
+         * @b Example
+         * @code {.cpp}
+         * // the robot is already 24 inches from the new target
+         * pid.reset(24);
+         * // only the proportional term acts on the first update
+         * float output = pid.update(24);
+         * @endcode
+         */
+        void reset(float error);
+
+        /**
+         * @brief Set the gains of the PID, without resetting it
+         *
+         * @param kP proportional gain
+         * @param kI integral gain
+         * @param kD derivative gain
+         *
+         * @b Example
+         * @code {.cpp}
+         * // create a PID
+         * PID pid(5, 0, 20);
+         * // use a higher proportional gain
+         * pid.setGains(8, 0, 20);
+         * @endcode
+         */
+        void setGains(float kP, float kI, float kD);
     protected:
         // gains
-        const float kP;
-        const float kI;
-        const float kD;
+        float kP;
+        float kI;
+        float kD;
 
         // optimizations
         const float windupRange;
         const bool signFlipReset;
 
+        float derivativeFilter = 0;
+        bool derivativeOnMeasurement = false;
+        float outputLimit = 0;
+        float trackingGain = 1;
+
         float integral = 0;
         float prevError = 0;
+        float derivative = 0;
+        std::optional<float> prevMeasurement = std::nullopt;
 };
 } // namespace lemlib
\ No newline at end of file
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#ifndef LEMLIB_DISABLE_PROFILER
+#include "pros/rtos.hpp"
+#endif
+
+namespace lemlib {
+/**
+ * @brief Sections of LemLib that are timed by the profiler
+ *
+ * Motion sections time a single iteration of the motion's control loop, not including the delay at the end of it.
+ */
+enum class ProfileSection {
+    ODOMETRY, /** one call to lemlib::update() */
+    TURN_TO_HEADING, /** one iteration of Chassis::turnToHeading */
+    TURN_TO_POINT, /** one iteration of Chassis::turnToPoint */
+    SWING_TO_HEADING, /** one iteration of Chassis::swingToHeading */
+    SWING_TO_POINT, /** one iteration of Chassis::swingToPoint */
+    MOVE_TO_POINT, /** one iteration of Chassis::moveToPoint */
+    MOVE_TO_POSE, /** one iteration of Chassis::moveToPose */
+    FOLLOW, /** one iteration of Chassis::follow */
+    LOGGER, /** formatting a single message in a sink */
+    DRIVE_CURVE, /** one call to ExpoDriveCurve::curve */
+    COUNT /** number of sections, not a real section */
+};
+
+/**
+ * @brief Timing statistics of a profiled section, in microseconds
+ */
+struct ProfileStats {
+        /** how many times the section was recorded */
+        uint32_t count = 0;
+        /** shortest recorded time */
+        uint32_t min = 0;
+        /** mean recorded time */
+        float avg = 0;
+        /** 99th percentile of recorded times. Resolution is limited by the histogram buckets */
+        uint32_t p99 = 0;
+        /** longest recorded time */
+        uint32_t max = 0;
+};
+
+/**
+ * @brief Record how long a section took to run
+ *
+ * This is called by ProfileScope, there is no need to call it manually unless you are timing your own code
+ *
+ * @param section the section that was timed
+ * @param time how long the section took, in microseconds
+ */
+void recordSectionTime(ProfileSection section, uint32_t time);
+
+/**
+ * @brief Get the timing statistics of a section
+ *
+ * @param section the section to get statistics for
+ * @return ProfileStats statistics in microseconds. All zero if nothing has been recorded
+ *
+ * @b Example
+ * @code {.cpp}
+ * lemlib::ProfileStats odom = lemlib::getSectionStats(lemlib::ProfileSection::ODOMETRY);
+ * pros::lcd::print(3, "odom p99: %d us", odom.p99);
+ * @endcode
+ */
+ProfileStats getSectionStats(ProfileSection section);
+
+/**
+ * @brief Clear the recorded timings of every section
+ */
+void resetSectionStats();
+
+/**
+ * @brief Send the statistics of every section that has been recorded to the telemetry sink
+ *
+ * Each section is sent as a single message in the form `PROFILE:{section},{count},{min},{avg},{p99},{max}`
+ *
+ * @b Example
+ * @code {.cpp}
+ * void disabled() {
+ *     // dump timings collected during autonomous
+ *     lemlib::logSectionStats();
+ * }
+ * @endcode
+ */
+void logSectionStats();
+
+/**
+ * @brief Format a profile section
+ *
+ * @param section
+ * @return std::string
+ */
+std::string format_as(ProfileSection section);
+
+#ifndef LEMLIB_DISABLE_PROFILER
+/**
+ * @brief Times a section from construction until stop() is called or it goes out of scope
+ *
+ * Use the LEMLIB_PROFILE and LEMLIB_PROFILE_END macros instead of using this class directly, so the timing can be
+ * removed by defining LEMLIB_DISABLE_PROFILER
+ */
+class ProfileScope {
+    public:
+        /**
+         * @brief Start timing a section
+         *
+         * @param section the section being timed
+         */
+        explicit ProfileScope(ProfileSection section)
+            : section(section),
+              start(pros::micros()) {}
+
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+
+        /**
+         * @brief Stop timing and record the elapsed time. Only the first call has an effect
+         */
+        void stop() {
+            if (stopped) return;
+            stopped = true;
+            recordSectionTime(section, pros::micros() - start);
+        }
+
+        ~ProfileScope() { stop(); }
+    private:
+        const ProfileSection section;
+        const uint64_t start;
+        bool stopped = false;
+};
+
+/** start timing a section until the end of the current scope */
+#define LEMLIB_PROFILE(section) lemlib::ProfileScope lemlibProfileScope(section)
+/** stop timing the section started with LEMLIB_PROFILE in the current scope */
+#define LEMLIB_PROFILE_END() lemlibProfileScope.stop()
+#else
+#define LEMLIB_PROFILE(section)                                                                                        \
+    do {                                                                                                               \
+    } while (0)
+#define LEMLIB_PROFILE_END()                                                                                           \
+    do {                                                                                                               \
+    } while (0)
+#endif
+} // namespace lemlib
@@ -1,8 +1,14 @@
 #pragma once
 
 #include <cstdint>
+#include "lemlib/clock.hpp"
 
 namespace lemlib {
+/**
+ * @brief Counts down from a set time
+ *
+ * Getters only read the clock, so they can be called as often as needed without changing the state of the timer
+ */
 class Timer {
     public:
         /**
@@ -14,6 +20,7 @@ class Timer {
          *       call set() before using the timer if you absolutely need to construct it in a global scope
          *
          * @param time how long to wait, in milliseconds
+         * @param clock the clock to measure time with. The real clock by default
          *
          * @b Example
          * @code {.cpp}
@@ -21,7 +28,7 @@ class Timer {
          * Timer timer(1000);
          * @endcode
          */
-        Timer(uint32_t time);
+        Timer(uint32_t time, Clock* clock = realClock());
         /**
          * @brief Get the amount of time the timer was set to
          *
@@ -35,7 +42,7 @@ class Timer {
          * const uint32_t time = timer.getTimeSet(); // time = 1000
          * @endcode
          */
-        uint32_t getTimeSet();
+        uint32_t getTimeSet() const;
         /**
          * @brief Get the amount of time left on the timer
          *
@@ -51,7 +58,7 @@ class Timer {
          * const uint32_t time = timer.getTimeLeft(); // time = 700
          * @endcode
          */
-        uint32_t getTimeLeft();
+        uint32_t getTimeLeft() const;
         /**
          * @brief Get the amount of time passed on the timer
          *
@@ -67,7 +74,7 @@ class Timer {
          * const uint32_t time = timer.getTimePassed(); // time = 300
          * @endcode
          */
-        uint32_t getTimePassed();
+        uint32_t getTimePassed() const;
         /**
          * @brief Get whether the timer is done or not
          *
@@ -88,7 +95,7 @@ class Timer {
          * const bool done = timer.isDone(); // done = true
          * @endcode
          */
-        bool isDone();
+        bool isDone() const;
         /**
          * @brief Get whether the timer is paused or not
          *
@@ -109,7 +116,7 @@ class Timer {
          * paused = timer.isPaused(); // paused = false
          * @endcode
          */
-        bool isPaused();
+        bool isPaused() const;
         /**
          * @brief Set the amount of time the timer should count down. Resets the timer
          *
@@ -193,8 +200,9 @@ class Timer {
         void waitUntilDone();
     private:
         uint32_t period;
-        uint32_t lastTime;
-        uint32_t timeWaited = 0;
+        Clock* clock;
+        uint32_t resumeTime; // when the timer was last reset or resumed
+        uint32_t timeWaited = 0; // time waited before the timer was last reset or resumed
         bool paused = false;
 };
-} // namespace lemlib
\ No newline at end of file
+} // namespace lemlib
@@ -0,0 +1,89 @@
+#include <chrono>
+#include <cstdio>
+#include "lemlib/clock.hpp"
+#include "lemlib/exitcondition.hpp"
+#include "lemlib/timer.hpp"
+
+/**
+ * Checks the timing of timers and exit conditions, by stepping them with a lemlib::ManualClock
+ *
+ * Usage: clockcheck
+ *
+ * Every check prints whether it passed. Exits with 1 if any check failed
+ */
+
+static int failures = 0;
+
+/**
+ * @brief Print the result of a check, and count it if it failed
+ *
+ * @param passed whether the check passed
+ * @param name what was checked
+ */
+static void check(bool passed, const char* name) {
+    std::printf("%s  %s\n", passed ? "pass" : "FAIL", name);
+    if (!passed) failures++;
+}
+
+/**
+ * @brief Update an exit condition every 10 ms of its clock until it exits
+ *
+ * @param exit the exit condition, using the clock
+ * @param clock the clock to step
+ * @param input the input to update the exit condition with
+ * @param velocity the velocity to update the exit condition with
+ * @param limit the longest time to step for, in milliseconds
+ * @return uint32_t how long it took to exit, in milliseconds. limit if it didn't exit
+ */
+static uint32_t timeToExit(lemlib::ExitCondition& exit, lemlib::ManualClock& clock, float input, float velocity,
+                           uint32_t limit) {
+    const uint32_t start = clock.millis();
+    while (clock.millis() - start < limit) {
+        if (exit.update(input, clock.millis(), velocity)) return clock.millis() - start;
+        clock.delay(10);
+    }
+    return limit;
+}
+
+int main() {
+    lemlib::ManualClock clock(1000);
+
+    lemlib::Timer timer(500, &clock);
+    clock.advance(499);
+    check(!timer.isDone() && timer.getTimeLeft() == 1, "timer isn't done 1 ms early");
+    timer.pause();
+    clock.advance(1000);
+    check(timer.getTimePassed() == 499, "paused timer doesn't count time");
+    timer.resume();
+    clock.advance(1);
+    check(timer.isDone() && timer.getTimeLeft() == 0, "timer is done on time");
+
+    // takes a second of clock time to finish, so it only runs fast if the clock doesn't wait
+    const auto wallStart = std::chrono::steady_clock::now();
+    lemlib::Timer longTimer(1000, &clock);
+    longTimer.waitUntilDone();
+    const auto wallTime = std::chrono::steady_clock::now() - wallStart;
+    check(longTimer.isDone() && wallTime < std::chrono::milliseconds(50), "waiting on a manual clock doesn't wait");
+
+    lemlib::ExitCondition exit(1, 100);
+    exit.setClock(&clock);
+    check(timeToExit(exit, clock, 0.5, 0, 1000) == 100, "exits after the time in range");
+    exit.reset();
+    check(timeToExit(exit, clock, 2, 0, 1000) == 1000, "doesn't exit out of range");
+
+    // in range for 500 ms, or in range and stopped for 50 ms
+    lemlib::ExitCondition settle(1, 500, 2, 1, 50);
+    settle.setClock(&clock);
+    // the rate of the input is only known from the second update, so the robot is seen as stopped 10 ms in
+    check(timeToExit(settle, clock, 0.5, 0, 1000) == 60, "exits after the stop time once stopped");
+    settle.reset();
+    check(timeToExit(settle, clock, 0.5, 5, 1000) == 1000, "doesn't exit while coasting through the range");
+    settle.reset();
+    settle.update(1.3, clock.millis());
+    clock.advance(100);
+    settle.update(0.5, clock.millis());
+    check(settle.predictSettleTime() == 500, "predicts the full time while the input is still moving");
+
+    std::printf("%d checks failed\n", failures);
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+/**
+ * Functions the LemLib sources get from the ARM toolchain, but that the host toolchain doesn't have. This header is
+ * included in every file the simulator compiles
+ */
+
+#include <limits>
+
+/**
+ * @brief newlib's infinity
+ *
+ * @return double positive infinity
+ */
+inline double infinity() { return std::numeric_limits<double>::infinity(); }
@@ -0,0 +1,261 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "lemlib/logger/binaryTelemetry.hpp"
+
+/**
+ * Decodes a capture of the binary telemetry stream sent by lemlib::BinaryTelemetry, or a recording made by
+ * lemlib::TelemetryRecorder, into CSV
+ *
+ * Usage: decode <capture file> [output prefix]
+ *
+ * Each telemetry channel is written to <output prefix>_<channel name>.csv, with a column for the time in microseconds,
+ * one for the sequence number, and one for each field. Samples of a channel are only decoded once its schema has been
+ * received. Frames that fail their CRC, like frames that were interleaved with text printed to the terminal, are
+ * skipped. Gaps in the sequence numbers are counted as lost samples.
+ *
+ * A recording is written to <output prefix>.csv, with a column for the time in microseconds and one for each channel.
+ *
+ * The files can be merged into one timeline with sim/build/merge
+ */
+
+/**
+ * @brief Undoes the wrapping of a counter that only has its low bits sent
+ *
+ * Works as long as consecutive values are less than half the range of the sent bits apart
+ */
+template <typename T> class Unwrapper {
+    public:
+        /**
+         * @brief Get the full value of the next sent value
+         */
+        uint64_t operator()(T value) {
+            if (!started) {
+                started = true;
+                last = value;
+            } else {
+                // the difference is signed, so values that arrive slightly out of order go backwards
+                last += std::make_signed_t<T>(value - T(last));
+            }
+            return last;
+        }
+    private:
+        bool started = false;
+        uint64_t last = 0;
+};
+
+/**
+ * @brief A channel that a schema has been received for
+ */
+struct Channel {
+        std::string name;
+        std::vector<std::string> fields;
+        FILE* file = nullptr;
+};
+
+/**
+ * @brief Decode a capture of the binary telemetry stream
+ *
+ * @param capture the captured bytes
+ * @param prefix prefix of the CSV files
+ * @return int exit code
+ */
+static int decodeTelemetry(const std::vector<uint8_t>& capture, const std::string& prefix) {
+    std::map<uint8_t, Channel> channels;
+    Unwrapper<uint32_t> unwrapTime;
+    Unwrapper<uint16_t> unwrapSequence;
+    uint64_t firstSequence = UINT64_MAX;
+    uint64_t lastSequence = 0;
+    int samples = 0;
+    int skipped = 0;
+    int corrupt = 0;
+    size_t start = 0;
+    for (size_t end = 0; end < capture.size(); end++) {
+        if (capture[end] != 0) continue;
+        const size_t size = end - start;
+        const uint8_t* encoded = capture.data() + start;
+        start = end + 1;
+        // consecutive delimiters, at the start of each batch
+        if (size == 0) continue;
+
+        const std::optional<std::vector<uint8_t>> frame = lemlib::cobsDecode(encoded, size);
+        if (!frame || frame->size() < 3 || lemlib::crc8(frame->data(), frame->size() - 1) != frame->back()) {
+            corrupt++;
+            continue;
+        }
+        const uint8_t id = frame->at(1);
+        const uint8_t* payload = frame->data() + 2;
+        const size_t payloadSize = frame->size() - 3;
+
+        if (frame->at(0) == static_cast<uint8_t>(lemlib::FrameType::SCHEMA)) {
+            // schemas are resent every second, so only the first one opens the file
+            if (channels.contains(id) || payloadSize < 1) continue;
+            Channel channel;
+            const uint8_t fieldCount = payload[0];
+            std::vector<std::string> strings;
+            const char* text = reinterpret_cast<const char*>(payload + 1);
+            const char* textEnd = reinterpret_cast<const char*>(payload + payloadSize);
+            while (text < textEnd) {
+                strings.emplace_back(text, strnlen(text, textEnd - text));
+                text += strings.back().size() + 1;
+            }
+            if (strings.size() != fieldCount + 1u) {
+                corrupt++;
+                continue;
+            }
+            channel.name = strings[0];
+            channel.fields.assign(strings.begin() + 1, strings.end());
+            const std::string path = prefix + "_" + channel.name + ".csv";
+            channel.file = std::fopen(path.c_str(), "w");
+            if (channel.file == nullptr) {
+                std::fprintf(stderr, "could not open %s\n", path.c_str());
+                return 1;
+            }
+            std::fprintf(channel.file, "time_us,sequence");
+            for (const std::string& field : channel.fields) std::fprintf(channel.file, ",%s", field.c_str());
+            std::fprintf(channel.file, "\n");
+            channels[id] = channel;
+        } else if (frame->at(0) == static_cast<uint8_t>(lemlib::FrameType::SAMPLE)) {
+            const auto channel = channels.find(id);
+            if (channel == channels.end()) {
+                skipped++;
+                continue;
+            }
+            const size_t fields = channel->second.fields.size();
+            constexpr size_t headerSize = sizeof(uint16_t) + sizeof(uint32_t);
+            if (payloadSize != headerSize + fields * sizeof(float)) {
+                corrupt++;
+                continue;
+            }
+            uint16_t number;
+            uint32_t micros;
+            std::memcpy(&number, payload, sizeof(number));
+            std::memcpy(&micros, payload + sizeof(number), sizeof(micros));
+            const uint64_t fullNumber = unwrapSequence(number);
+            firstSequence = std::min(firstSequence, fullNumber);
+            lastSequence = std::max(lastSequence, fullNumber);
+            std::fprintf(channel->second.file, "%llu,%llu", (unsigned long long)unwrapTime(micros),
+                         (unsigned long long)fullNumber);
+            for (size_t i = 0; i < fields; i++) {
+                float value;
+                std::memcpy(&value, payload + headerSize + i * sizeof(float), sizeof(value));
+                std::fprintf(channel->second.file, ",%g", value);
+            }
+            std::fprintf(channel->second.file, "\n");
+            samples++;
+        } else {
+            corrupt++;
+        }
+    }
+
+    for (const auto& [id, channel] : channels) {
+        std::fclose(channel.file);
+        std::printf("%s_%s.csv\n", prefix.c_str(), channel.name.c_str());
+    }
+    // samples skipped before their schema still used up a sequence number
+    const long long received = samples + skipped;
+    const long long lost = received == 0 ? 0 : (long long)(lastSequence - firstSequence + 1) - received;
+    std::printf("%d samples, %d before their schema, %d corrupt frames, %lld lost\n", samples, skipped, corrupt, lost);
+    return 0;
+}
+
+/**
+ * @brief Decode a recording made by lemlib::TelemetryRecorder
+ *
+ * @param capture the captured bytes, starting at the magic of the recording
+ * @param size number of bytes
+ * @param prefix prefix of the CSV file
+ * @return int exit code
+ */
+static int decodeRecording(const uint8_t* capture, size_t size, const std::string& prefix) {
+    size_t position = 4;
+    // copy a value out of the capture, and move past it
+    auto read = [&](auto& value) {
+        if (position + sizeof(value) > size) return false;
+        std::memcpy(&value, capture + position, sizeof(value));
+        position += sizeof(value);
+        return true;
+    };
+
+    uint8_t version;
+    uint16_t channelCount;
+    uint16_t rowsPerBlock;
+    // version 1 recorded the time in milliseconds
+    if (!read(version) || !read(channelCount) || !read(rowsPerBlock) || version < 1 || version > 2) {
+        std::fprintf(stderr, "unsupported recording\n");
+        return 1;
+    }
+    std::vector<std::string> names;
+    for (int i = 0; i < channelCount; i++) {
+        const char* name = reinterpret_cast<const char*>(capture + position);
+        names.emplace_back(name, strnlen(name, size - position));
+        position += names.back().size() + 1;
+    }
+
+    const std::string path = prefix + ".csv";
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (file == nullptr) {
+        std::fprintf(stderr, "could not open %s\n", path.c_str());
+        return 1;
+    }
+    std::fprintf(file, "time_us");
+    for (const std::string& name : names) std::fprintf(file, ",%s", name.c_str());
+    std::fprintf(file, "\n");
+
+    // each block is its row count, then each column: the timestamps, then the samples of each channel
+    Unwrapper<uint32_t> unwrap;
+    int rows = 0;
+    uint16_t count;
+    while (read(count)) {
+        const size_t columnSize = size_t(count) * sizeof(float);
+        if (count > rowsPerBlock || position + columnSize * (channelCount + 1) > size) {
+            std::fprintf(stderr, "recording is truncated\n");
+            break;
+        }
+        const uint8_t* block = capture + position;
+        for (int row = 0; row < count; row++) {
+            uint32_t time;
+            std::memcpy(&time, block + row * sizeof(float), sizeof(time));
+            const uint64_t micros = version == 1 ? uint64_t(time) * 1000 : unwrap(time);
+            std::fprintf(file, "%llu", (unsigned long long)micros);
+            for (int channel = 1; channel <= channelCount; channel++) {
+                float value;
+                std::memcpy(&value, block + channel * columnSize + row * sizeof(float), sizeof(value));
+                std::fprintf(file, ",%g", value);
+            }
+            std::fprintf(file, "\n");
+        }
+        position += columnSize * (channelCount + 1);
+        rows += count;
+    }
+
+    std::fclose(file);
+    std::printf("%s\n%d rows of %d channels\n", path.c_str(), rows, channelCount);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <capture file> [output prefix]\n", argv[0]);
+        return 1;
+    }
+    std::ifstream input(argv[1], std::ios::binary);
+    if (!input) {
+        std::fprintf(stderr, "could not open %s\n", argv[1]);
+        return 1;
+    }
+    const std::string prefix = argc > 2 ? argv[2] : "telemetry";
+    const std::vector<uint8_t> capture {std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()};
+
+    // a recording sent to the terminal may have text printed before it
+    const std::string magic = "LLRC";
+    const auto start = std::search(capture.begin(), capture.end(), magic.begin(), magic.end());
+    if (start != capture.end()) return decodeRecording(&*start, capture.end() - start, prefix);
+    return decodeTelemetry(capture, prefix);
+}
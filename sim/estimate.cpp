@@ -0,0 +1,159 @@
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include "lemlib/api.hpp" // IWYU pragma: keep
+#include "lemlib/chassis/routineEstimator.hpp"
+
+/**
+ * Estimates how long a routine takes on the robot in src/main.cpp, and whether it fits in the autonomous period
+ *
+ * Usage: estimate <routine file> [budget in ms]
+ *
+ * Each line of the routine file is a motion, with the same arguments as the chassis function, followed by any
+ * parameters as name=value. Blank lines and lines starting with # are ignored. For example:
+ *
+ *     setPose 0 0 0
+ *     moveToPoint 0 24 2000
+ *     turnToHeading 90 1000 direction=cw
+ *     moveToPose 24 36 0 3000 lead=0.4 maxSpeed=100
+ *     swingToHeading 180 left 1000
+ *     delay 500
+ *
+ * Exits with 1 if the routine runs past the budget
+ */
+
+/**
+ * @brief Parse an angular direction
+ *
+ * @param value cw, ccw, or auto
+ * @return AngularDirection the direction
+ */
+static AngularDirection direction(const std::string& value) {
+    if (value == "cw") return AngularDirection::CW_CLOCKWISE;
+    if (value == "ccw") return AngularDirection::CCW_COUNTERCLOCKWISE;
+    return AngularDirection::AUTO;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <routine file> [budget in ms]\n", argv[0]);
+        return 2;
+    }
+    std::ifstream file(argv[1]);
+    if (!file) {
+        std::fprintf(stderr, "couldn't open %s\n", argv[1]);
+        return 2;
+    }
+    const float budget = argc > 2 ? std::atof(argv[2]) : 15000;
+
+    // same drivetrain and controllers as the robot
+    lemlib::Drivetrain drivetrain(nullptr, nullptr, 12, lemlib::Omniwheel::NEW_325, 450, 2);
+    lemlib::ControllerSettings linearController(10, 0, 3, 3, 1, 100, 3, 500, 20);
+    lemlib::ControllerSettings angularController(2, 0, 10, 3, 1, 100, 3, 500, 0);
+    lemlib::RoutineEstimator estimator(drivetrain, linearController, angularController, budget);
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        std::istringstream stream(line);
+        std::string motion;
+        if (!(stream >> motion) || motion[0] == '#') continue;
+        // split the positional arguments from the named parameters
+        std::vector<std::string> args;
+        std::map<std::string, std::string> named;
+        for (std::string token; stream >> token;) {
+            const size_t equals = token.find('=');
+            if (equals == std::string::npos) args.push_back(token);
+            else named[token.substr(0, equals)] = token.substr(equals + 1);
+        }
+        // set to the first argument that isn't a number, so the line can be reported once it has been parsed
+        std::optional<std::string> invalid = std::nullopt;
+        auto number = [&](const std::string& text) {
+            char* end;
+            const float value = std::strtof(text.c_str(), &end);
+            if ((end == text.c_str() || *end != '\0') && !invalid) invalid = text;
+            return value;
+        };
+        auto arg = [&](size_t i) { return i < args.size() ? number(args[i]) : 0.0f; };
+        auto param = [&](const std::string& name, float fallback) {
+            return named.contains(name) ? number(named[name]) : fallback;
+        };
+        auto flag = [&](const std::string& name, bool fallback) {
+            return named.contains(name) ? named[name] == "true" : fallback;
+        };
+        const DriveSide side = args.size() > 1 && args[1] == "right" ? DriveSide::RIGHT : DriveSide::LEFT;
+
+        if (motion == "setPose") estimator.setPose(arg(0), arg(1), arg(2));
+        else if (motion == "moveToPoint")
+            estimator.moveToPoint(arg(0), arg(1), arg(2),
+                                  {.forwards = flag("forwards", true),
+                                   .maxSpeed = param("maxSpeed", 127),
+                                   .minSpeed = param("minSpeed", 0),
+                                   .earlyExitRange = param("earlyExitRange", 0),
+                                   .profiled = flag("profiled", false),
+                                   .maxAccel = param("maxAccel", 0),
+                                   .maxJerk = param("maxJerk", 0)});
+        else if (motion == "moveToPose")
+            estimator.moveToPose(arg(0), arg(1), arg(2), arg(3),
+                                 {.forwards = flag("forwards", true),
+                                  .lead = param("lead", 0.6),
+                                  .maxSpeed = param("maxSpeed", 127),
+                                  .minSpeed = param("minSpeed", 0),
+                                  .earlyExitRange = param("earlyExitRange", 0)});
+        else if (motion == "turnToHeading")
+            estimator.turnToHeading(arg(0), arg(1),
+                                    {.direction = direction(named["direction"]),
+                                     .maxSpeed = int(param("maxSpeed", 127)),
+                                     .minSpeed = int(param("minSpeed", 0)),
+                                     .earlyExitRange = param("earlyExitRange", 0)});
+        else if (motion == "turnToPoint")
+            estimator.turnToPoint(arg(0), arg(1), arg(2),
+                                  {.forwards = flag("forwards", true),
+                                   .direction = direction(named["direction"]),
+                                   .maxSpeed = int(param("maxSpeed", 127)),
+                                   .minSpeed = int(param("minSpeed", 0)),
+                                   .earlyExitRange = param("earlyExitRange", 0)});
+        else if (motion == "swingToHeading")
+            estimator.swingToHeading(arg(0), side, arg(2),
+                                     {.direction = direction(named["direction"]),
+                                      .maxSpeed = param("maxSpeed", 127),
+                                      .minSpeed = param("minSpeed", 0),
+                                      .earlyExitRange = param("earlyExitRange", 0)});
+        else if (motion == "swingToPoint") {
+            const DriveSide pointSide = args.size() > 2 && args[2] == "right" ? DriveSide::RIGHT : DriveSide::LEFT;
+            estimator.swingToPoint(arg(0), arg(1), pointSide, arg(3),
+                                   {.forwards = flag("forwards", true),
+                                    .direction = direction(named["direction"]),
+                                    .maxSpeed = param("maxSpeed", 127),
+                                    .minSpeed = param("minSpeed", 0),
+                                    .earlyExitRange = param("earlyExitRange", 0)});
+        } else if (motion == "delay") estimator.delay(arg(0));
+        else {
+            std::fprintf(stderr, "line %d: unknown motion %s\n", lineNumber, motion.c_str());
+            return 2;
+        }
+        if (invalid) {
+            std::fprintf(stderr, "line %d: %s is not a number\n", lineNumber, invalid->c_str());
+            return 2;
+        }
+    }
+
+    std::printf("%4s  %-16s%12s%12s\n", "#", "motion", "time (ms)", "timeout");
+    for (const lemlib::MotionEstimate& motion : estimator.getMotions()) {
+        std::printf("%4d  %-16s%12.0f%12.0f%s\n", motion.index, motion.name.c_str(), motion.duration, motion.timeout,
+                    motion.timesOut ? "  (times out)" : "");
+    }
+    const float duration = estimator.getDuration();
+    std::printf("\ntotal: %.0f ms of %.0f ms\n", duration, budget);
+    if (estimator.fitsBudget()) return 0;
+    std::printf("over budget by %.0f ms. Most expensive motions:\n", duration - budget);
+    for (const lemlib::MotionEstimate& motion : estimator.getMostExpensive()) {
+        std::printf("%4d  %-16s%12.0f\n", motion.index, motion.name.c_str(), motion.duration);
+    }
+    return 1;
+}
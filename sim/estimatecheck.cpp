@@ -0,0 +1,89 @@
+#include <cmath>
+#include <cstdio>
+#include <unistd.h>
+#include "lemlib/api.hpp" // IWYU pragma: keep
+#include "lemlib/chassis/routineEstimator.hpp"
+#include "sim.hpp"
+
+/**
+ * Checks the routine estimator against the simulator, by estimating and simulating the routine of sim/example.cpp on
+ * the same robot
+ *
+ * Usage: estimatecheck
+ *
+ * Every check prints whether it passed. Exits with 1 if any check failed
+ */
+
+// how far the estimate can be from the simulated duration, as a fraction of the simulated duration
+constexpr float TOLERANCE = 0.15;
+
+// same devices as the robot
+pros::MotorGroup leftMotors({8, 10, 14}, pros::MotorGearset::blue);
+pros::MotorGroup rightMotors({-1, -2, -3}, pros::MotorGearset::blue);
+pros::Imu imu(9);
+pros::Rotation horizontalEnc(15);
+pros::Rotation verticalEnc(5);
+lemlib::TrackingWheel horizontal(&horizontalEnc, lemlib::Omniwheel::NEW_275, -5.75);
+lemlib::TrackingWheel vertical(&verticalEnc, lemlib::Omniwheel::NEW_275, -2.5);
+
+lemlib::Drivetrain drivetrain(&leftMotors, &rightMotors, 12, lemlib::Omniwheel::NEW_325, 450, 2);
+lemlib::ControllerSettings linearController(10, 0, 3, 3, 1, 100, 3, 500, 20);
+lemlib::ControllerSettings angularController(2, 0, 10, 3, 1, 100, 3, 500, 0);
+lemlib::OdomSensors sensors(&vertical, nullptr, &horizontal, nullptr, &imu);
+lemlib::Chassis chassis(drivetrain, linearController, angularController, sensors);
+
+static int failures = 0;
+
+/**
+ * @brief Print the result of a check, and count it if it failed
+ *
+ * @param passed whether the check passed
+ * @param name what was checked
+ */
+static void check(bool passed, const char* name) {
+    std::printf("%s  %s\n", passed ? "pass" : "FAIL", name);
+    if (!passed) failures++;
+}
+
+int main() {
+    lemlib::RoutineEstimator estimator(drivetrain, linearController, angularController);
+    estimator.setPose(0, 0, 0);
+    estimator.moveToPoint(0, 24, 2000);
+    estimator.turnToHeading(90, 1000);
+    estimator.moveToPose(24, 36, 0, 3000);
+    estimator.moveToPoint(0, 0, 3000, {.forwards = false});
+
+    sim::configure({
+        .leftPorts = {8, 10, 14},
+        .rightPorts = {-1, -2, -3},
+        .trackWidth = 12,
+        .wheelDiameter = 3.25,
+        .rpm = 450,
+        .imuPort = 9,
+        .imuDrift = 0.01,
+        .trackingWheels = {{15, 2.75, -5.75, false}, {5, 2.75, -2.5, true}},
+    });
+    const sim::Report report = sim::run(
+        [] {
+            chassis.calibrate();
+            chassis.setNominalVoltage(11.5);
+        },
+        [] {
+            chassis.setPose(0, 0, 0);
+            chassis.moveToPoint(0, 24, 2000);
+            chassis.turnToHeading(90, 1000);
+            chassis.moveToPose(24, 36, 0, 3000);
+            chassis.moveToPoint(0, 0, 3000, {.forwards = false});
+            chassis.waitUntilDone();
+        });
+
+    const float estimated = estimator.getDuration() / 1000;
+    std::printf("estimated %.3f s, simulated %.3f s\n", estimated, report.duration);
+    check(std::fabs(estimated - report.duration) <= report.duration * TOLERANCE,
+          "the estimate is within 15% of the simulated duration");
+
+    std::printf("%d checks failed\n", failures);
+    std::fflush(stdout);
+    // tasks started by the routine are still blocked in the scheduler, so don't wait for them
+    _exit(failures > 0 ? 1 : 0);
+}
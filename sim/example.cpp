@@ -0,0 +1,65 @@
+#include <cstdio>
+#include <unistd.h>
+#include "lemlib/api.hpp" // IWYU pragma: keep
+#include "sim.hpp"
+
+/**
+ * Runs a short routine on a simulated copy of the robot in src/main.cpp, and prints what happened
+ */
+
+// same devices as the robot
+pros::MotorGroup leftMotors({8, 10, 14}, pros::MotorGearset::blue);
+pros::MotorGroup rightMotors({-1, -2, -3}, pros::MotorGearset::blue);
+pros::Imu imu(9);
+pros::Rotation horizontalEnc(15);
+pros::Rotation verticalEnc(5);
+lemlib::TrackingWheel horizontal(&horizontalEnc, lemlib::Omniwheel::NEW_275, -5.75);
+lemlib::TrackingWheel vertical(&verticalEnc, lemlib::Omniwheel::NEW_275, -2.5);
+
+lemlib::Drivetrain drivetrain(&leftMotors, &rightMotors, 12, lemlib::Omniwheel::NEW_325, 450, 2);
+lemlib::ControllerSettings linearController(10, 0, 3, 3, 1, 100, 3, 500, 20);
+lemlib::ControllerSettings angularController(2, 0, 10, 3, 1, 100, 3, 500, 0);
+lemlib::OdomSensors sensors(&vertical, nullptr, &horizontal, nullptr, &imu);
+lemlib::Chassis chassis(drivetrain, linearController, angularController, sensors);
+
+int main() {
+    sim::RobotConfig robot = {
+        .leftPorts = {8, 10, 14},
+        .rightPorts = {-1, -2, -3},
+        .trackWidth = 12,
+        .wheelDiameter = 3.25,
+        .rpm = 450,
+        .imuPort = 9,
+        .imuDrift = 0.01,
+        .trackingWheels = {{15, 2.75, -5.75, false}, {5, 2.75, -2.5, true}},
+    };
+    sim::configure(robot);
+
+    const sim::Report report = sim::run(
+        [] {
+            chassis.calibrate();
+            chassis.setNominalVoltage(11.5);
+        },
+        [] {
+            chassis.setPose(0, 0, 0);
+            chassis.moveToPoint(0, 24, 2000);
+            chassis.turnToHeading(90, 1000);
+            chassis.moveToPose(24, 36, 0, 3000);
+            chassis.moveToPoint(0, 0, 3000, {.forwards = false});
+            chassis.waitUntilDone();
+        });
+
+    const lemlib::Pose odom = chassis.getPose();
+    std::printf("duration:         %.3f s%s\n", report.duration, report.timedOut ? " (timed out)" : "");
+    std::printf("final pose:       x %.2f, y %.2f, theta %.2f\n", report.finalPose.x, report.finalPose.y,
+                report.finalPose.theta);
+    std::printf("odometry pose:    x %.2f, y %.2f, theta %.2f\n", odom.x, odom.y, odom.theta);
+    std::printf("odometry error:   %.3f in final, %.3f in max\n", report.finalOdomError, report.maxOdomError);
+    std::printf("energy:           %.1f J\n", report.energy);
+    std::printf("effort:           %.1f %%\n", report.effort * 100);
+    std::printf("max speed:        %.1f in/s\n", report.maxSpeed);
+    std::printf("max acceleration: %.1f in/s^2\n", report.maxAccel);
+    std::fflush(stdout);
+    // tasks started by the routine are still blocked in the scheduler, so don't wait for them
+    _exit(0);
+}
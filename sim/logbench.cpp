@@ -0,0 +1,333 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include "lemlib/api.hpp" // IWYU pragma: keep
+#include "sim.hpp"
+
+/**
+ * Benchmarks the logging stack, and prints the results as CSV so runs can be compared
+ *
+ * Usage: logbench [baseline.csv]
+ *
+ * Measures:
+ * - how many log calls per second the task that logs can make, for info and debug messages that are enabled, filtered
+ *   out by the level of the sink, removed by LEMLIB_DEBUG, and deferred to the formatting task
+ * - the heap allocations made per call, which should be 0 once the logger has warmed up
+ * - the cost of a combined sink sending to 1, 2 and 4 sinks
+ * - how many bytes per second a Buffer drains at different rates
+ * - how much the heap grows while logging
+ * - the latency from a log call to the message being handed to the output, formatted immediately and deferred
+ *
+ * Calls are timed in real time, in bursts with a delay in between like a motion loop, so the deferred ring never fills
+ * up. Throughput and latency are measured in simulated time, since they depend on how often the buffer tasks wake up
+ * rather than on how fast the computer is.
+ *
+ * Each result is a line of benchmark,metric,value,unit. Given the output of an earlier run, results that got more than
+ * 25% worse are printed to stderr, and the exit code is 1.
+ */
+
+// calls per burst, and bursts per measurement
+constexpr int BURST = 5;
+constexpr int BURSTS = 20000;
+// how much worse a result can get before it is reported as a regression
+constexpr double TOLERANCE = 0.25;
+
+// every heap allocation made by the program, and the bytes currently allocated
+static std::atomic<uint64_t> allocations = 0;
+static std::atomic<int64_t> heapInUse = 0;
+static std::atomic<int64_t> heapPeak = 0;
+// allocations store their size before the memory they return, at an offset that keeps the memory aligned
+constexpr size_t SIZE_HEADER = alignof(std::max_align_t);
+
+void* operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    const int64_t inUse = heapInUse.fetch_add(size, std::memory_order_relaxed) + size;
+    int64_t peak = heapPeak.load(std::memory_order_relaxed);
+    while (inUse > peak && !heapPeak.compare_exchange_weak(peak, inUse, std::memory_order_relaxed)) {}
+    char* block = static_cast<char*>(std::malloc(size + SIZE_HEADER));
+    if (block == nullptr) throw std::bad_alloc();
+    std::memcpy(block, &size, sizeof(size));
+    return block + SIZE_HEADER;
+}
+
+void operator delete(void* memory) noexcept {
+    if (memory == nullptr) return;
+    char* block = static_cast<char*>(memory) - SIZE_HEADER;
+    size_t size;
+    std::memcpy(&size, block, sizeof(size));
+    heapInUse.fetch_sub(size, std::memory_order_relaxed);
+    std::free(block);
+}
+
+void operator delete(void* memory, size_t) noexcept { operator delete(memory); }
+
+/**
+ * @brief A sink that counts the messages it would have sent, so the benchmark doesn't measure printing
+ */
+class CountingSink : public lemlib::BaseSink {
+    public:
+        CountingSink() { setFormat("[LemLib] {time} {level}: {message}"); }
+
+        ~CountingSink() { stopQueue(); }
+
+        int sent = 0;
+    private:
+        void sendMessage(const lemlib::Message& message) override { sent++; }
+};
+
+/**
+ * @brief A sink that sends the time each message was logged through a buffer, and records how long each message took
+ * to come out of the buffer
+ */
+class LatencySink : public lemlib::BaseSink {
+    public:
+        /**
+         * @param rate how often the buffer is drained, in milliseconds
+         */
+        LatencySink(uint32_t rate)
+            : buffer([this](const std::string& batch) {
+                  const uint64_t now = pros::micros();
+                  for (size_t i = 0; i + sizeof(uint64_t) <= batch.size(); i += sizeof(uint64_t)) {
+                      uint64_t logged;
+                      std::memcpy(&logged, batch.data() + i, sizeof(logged));
+                      if (count < latencies.size()) latencies[count++] = now - logged;
+                  }
+              }) {
+            setFormat("{message}");
+            buffer.setRate(rate);
+        }
+
+        ~LatencySink() { stopQueue(); }
+
+        std::vector<uint64_t> latencies = std::vector<uint64_t>(10000);
+        std::atomic<size_t> count = 0;
+    private:
+        void sendMessage(const lemlib::Message& message) override {
+            buffer.pushToBuffer(reinterpret_cast<const char*>(&message.micros), sizeof(message.micros));
+        }
+
+        lemlib::Buffer buffer;
+};
+
+/**
+ * @brief A result of a benchmark
+ */
+struct Result {
+        std::string benchmark;
+        std::string metric;
+        double value;
+        std::string unit;
+};
+
+static std::vector<Result> results;
+
+/**
+ * @brief Check whether a bigger value of a unit is better
+ */
+static bool higherIsBetter(const std::string& unit) { return unit == "calls/s" || unit == "bytes/s"; }
+
+/**
+ * @brief Time a log call, made the way a motion loop makes it
+ *
+ * @param benchmark name of the benchmark
+ * @param call makes one log call
+ */
+template <typename F> static void measureCalls(const std::string& benchmark, F call) {
+    // warm up, so allocations made once, like starting the deferred task, aren't counted
+    call();
+    pros::delay(200);
+    std::chrono::nanoseconds total {0};
+    const uint64_t startAllocations = allocations.load();
+    for (int i = 0; i < BURSTS; i++) {
+        const auto start = std::chrono::steady_clock::now();
+        for (int j = 0; j < BURST; j++) call();
+        total += std::chrono::steady_clock::now() - start;
+        pros::delay(10);
+    }
+    // let the deferred messages drain, so their allocations are counted too
+    pros::delay(200);
+    // counted before the results are added, since adding them allocates
+    const uint64_t callAllocations = allocations.load() - startAllocations;
+    const double calls = BURST * BURSTS;
+    results.push_back({benchmark, "rate", calls / (double(total.count()) / 1e9), "calls/s"});
+    results.push_back({benchmark, "allocations", callAllocations / calls, "allocs/call"});
+}
+
+/**
+ * @brief Measure how many bytes per second a buffer drains, with a producer that never lets it empty
+ *
+ * @param rate how often the buffer is drained, in milliseconds
+ */
+static void measureDrain(uint32_t rate) {
+    static std::atomic<uint64_t> drained;
+    drained = 0;
+    // buffer tasks run forever, so the buffer is never destroyed
+    auto* buffer = new lemlib::Buffer([](const std::string& batch) { drained += batch.size(); }, 4096,
+                                      lemlib::DropPolicy::BLOCK);
+    buffer->setRate(rate);
+    const std::array<char, 64> record {};
+    const uint64_t start = pros::micros();
+    while (pros::micros() - start < 1000000) {
+        for (int i = 0; i < 64; i++) buffer->pushToBuffer(record.data(), record.size());
+        pros::delay(1);
+    }
+    const double seconds = double(pros::micros() - start) / 1e6;
+    results.push_back({"drain_" + std::to_string(rate) + "ms", "throughput", drained / seconds, "bytes/s"});
+}
+
+/**
+ * @brief Measure the latency from a log call to the message coming out of the buffer of a sink
+ *
+ * Deferred messages wait for the deferred task, then for the buffer of the sink. How long the second wait is depends on
+ * when one task drains compared to the other, which is arbitrary on the brain, so the latency is measured with sinks
+ * whose buffers drain at every point in the period of the deferred task
+ *
+ * @param benchmark name of the benchmark
+ * @param deferred whether the message is formatted by the deferred task
+ */
+static void measureLatency(const std::string& benchmark, bool deferred) {
+    constexpr uint32_t RATE = 50;
+    constexpr uint32_t PHASES = 10;
+    std::vector<uint64_t> latencies;
+    for (uint32_t phase = 0; phase < PHASES; phase++) {
+        // the buffer task runs forever, so the sink is never destroyed. Drained at the same rate as the terminal
+        auto* sink = new LatencySink(RATE);
+        sink->setLowestLevel(lemlib::Level::INFO);
+        sink->setDeferred(deferred);
+        // not a divisor of the rate, so messages are logged at every point in the period of the buffer
+        for (int i = 0; i < 50; i++) {
+            sink->info("{}", i);
+            pros::delay(7);
+        }
+        pros::delay(2 * RATE);
+        latencies.insert(latencies.end(), sink->latencies.begin(), sink->latencies.begin() + sink->count);
+        // start the next sink later in the period
+        pros::delay(RATE / PHASES);
+    }
+    if (latencies.empty()) return;
+    std::sort(latencies.begin(), latencies.end());
+    double sum = 0;
+    for (uint64_t latency : latencies) sum += latency;
+    results.push_back({benchmark, "mean", sum / latencies.size(), "us"});
+    results.push_back({benchmark, "p99", double(latencies[latencies.size() * 99 / 100]), "us"});
+    results.push_back({benchmark, "max", double(latencies.back()), "us"});
+}
+
+/**
+ * @brief Run every benchmark
+ */
+static void runSuite() {
+    const auto sink = std::make_shared<CountingSink>();
+    float power = 0;
+    auto logInfo = [&] { sink->info("Pose: {:.2f}, {:.2f}, {:.2f}, power: {}", 12.5f, -3.25f, 90.0f, power++); };
+    auto logDebug = [&] { sink->debug("Pose: {:.2f}, {:.2f}, {:.2f}, power: {}", 12.5f, -3.25f, 90.0f, power++); };
+
+    sink->setLowestLevel(lemlib::Level::INFO);
+    measureCalls("info_enabled", logInfo);
+    measureCalls("debug_enabled", logDebug);
+    sink->setDeferred(true);
+    measureCalls("info_deferred", logInfo);
+    sink->setDeferred(false);
+    sink->setLowestLevel(lemlib::Level::WARN);
+    measureCalls("info_disabled", logInfo);
+    measureCalls("debug_disabled", logDebug);
+    measureCalls("debug_disabled_macro",
+                 [&] { LEMLIB_DEBUG(sink, "Pose: {:.2f}, {:.2f}, {:.2f}, power: {}", 12.5f, -3.25f, 90.0f, power++); });
+
+    // fan out to more and more sinks
+    const std::array<std::shared_ptr<CountingSink>, 4> sinks {
+        std::make_shared<CountingSink>(), std::make_shared<CountingSink>(), std::make_shared<CountingSink>(),
+        std::make_shared<CountingSink>()};
+    lemlib::BaseSink combined1({sinks[0]});
+    lemlib::BaseSink combined2({sinks[0], sinks[1]});
+    lemlib::BaseSink combined4({sinks[0], sinks[1], sinks[2], sinks[3]});
+    combined4.setLowestLevel(lemlib::Level::INFO);
+    auto logCombined = [&](lemlib::BaseSink& combined) {
+        return [&] { combined.info("Pose: {:.2f}, {:.2f}, {:.2f}, power: {}", 12.5f, -3.25f, 90.0f, power++); };
+    };
+    measureCalls("combined_1", logCombined(combined1));
+    measureCalls("combined_2", logCombined(combined2));
+    measureCalls("combined_4", logCombined(combined4));
+
+    for (uint32_t rate : {1, 10, 50}) measureDrain(rate);
+
+    // everything has warmed up by now, so any growth is the logger allocating while it runs
+    const int64_t heapBefore = heapInUse.load();
+    heapPeak = heapBefore;
+    sink->setLowestLevel(lemlib::Level::INFO);
+    for (int i = 0; i < 1000; i++) {
+        logInfo();
+        if (i % BURST == 0) pros::delay(10);
+    }
+    results.push_back({"heap", "high_water_growth", double(heapPeak.load() - heapBefore), "bytes"});
+
+    measureLatency("latency_immediate", false);
+    measureLatency("latency_deferred", true);
+}
+
+/**
+ * @brief Compare the results to an earlier run
+ *
+ * @param path path of the output of the earlier run
+ * @return int number of results that got worse
+ */
+static int compare(const char* path) {
+    std::ifstream input(path);
+    if (!input) {
+        std::fprintf(stderr, "could not open %s\n", path);
+        return 1;
+    }
+    std::map<std::string, double> baseline;
+    std::string line;
+    while (std::getline(input, line)) {
+        std::stringstream fields(line);
+        std::string benchmark, metric, value;
+        if (!std::getline(fields, benchmark, ',') || !std::getline(fields, metric, ',') ||
+            !std::getline(fields, value, ','))
+            continue;
+        baseline[benchmark + "," + metric] = std::atof(value.c_str());
+    }
+
+    int regressions = 0;
+    for (const Result& result : results) {
+        const auto old = baseline.find(result.benchmark + "," + result.metric);
+        if (old == baseline.end()) continue;
+        const double change = higherIsBetter(result.unit) ? old->second - result.value : result.value - old->second;
+        // values near 0, like allocations per call, only regress if they actually went up
+        if (change > TOLERANCE * std::abs(old->second) && change > 1e-3) {
+            std::fprintf(stderr, "regression: %s %s went from %g to %g %s\n", result.benchmark.c_str(),
+                         result.metric.c_str(), old->second, result.value, result.unit.c_str());
+            regressions++;
+        }
+    }
+    return regressions;
+}
+
+int main(int argc, char** argv) {
+    // allocated up front, so adding results isn't counted as the logger allocating
+    results.reserve(64);
+    sim::configure({});
+    sim::run([] {}, runSuite, UINT32_MAX);
+
+    std::printf("benchmark,metric,value,unit\n");
+    for (const Result& result : results) {
+        std::printf("%s,%s,%g,%s\n", result.benchmark.c_str(), result.metric.c_str(), result.value,
+                    result.unit.c_str());
+    }
+    const int regressions = argc > 1 ? compare(argv[1]) : 0;
+    std::fflush(stdout);
+    std::fflush(stderr);
+    // the buffer tasks are still blocked in the scheduler, so don't wait for them
+    _exit(regressions > 0 ? 1 : 0);
+}
@@ -0,0 +1,120 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "lemlib/logger/lz4.hpp"
+
+/**
+ * Prints the messages in a file written by lemlib::FileSink
+ *
+ * Usage: logcat <log file> [from ms] [to ms]
+ *
+ * Only segments with messages logged between the two times are read. Their offsets are looked up in the index next to
+ * the file, prefix_000.idx for prefix_000.log, so the rest of the file is skipped. Without an index, the header of
+ * every segment is read instead. Segments of raw records, like binary telemetry frames, are printed as they were
+ * written, so they can be piped to a file and decoded.
+ */
+
+// identifies the start of a segment, and its flags
+constexpr char MAGIC[4] = {'L', 'L', 'S', 'G'};
+constexpr uint8_t COMPRESSED = 1;
+constexpr size_t ALIGNMENT = 512;
+
+/**
+ * @brief Written before the data of each segment, the same as in fileSink.cpp
+ */
+struct SegmentHeader {
+        char magic[4];
+        uint8_t version;
+        uint8_t flags;
+        uint16_t reserved;
+        uint32_t size;
+        uint32_t storedSize;
+        uint32_t firstTime;
+        uint32_t lastTime;
+};
+
+/**
+ * @brief An entry in the index of a file, the same as in fileSink.cpp
+ */
+struct IndexEntry {
+        uint32_t offset;
+        uint32_t firstTime;
+        uint32_t lastTime;
+};
+
+/**
+ * @brief Find the segments of a file
+ *
+ * @param log the log file
+ * @param path path of the log file, to find its index
+ * @return std::vector<IndexEntry> the offset and times of each segment
+ */
+static std::vector<IndexEntry> findSegments(FILE* log, const std::string& path) {
+    std::vector<IndexEntry> entries;
+    const size_t extension = path.rfind(".log");
+    FILE* index =
+        extension == std::string::npos ? nullptr : std::fopen((path.substr(0, extension) + ".idx").c_str(), "rb");
+    if (index != nullptr) {
+        IndexEntry entry;
+        while (std::fread(&entry, sizeof(entry), 1, index) == 1) entries.push_back(entry);
+        std::fclose(index);
+        return entries;
+    }
+
+    // segments are padded to the alignment, so each header is right after the padding of the last segment
+    SegmentHeader header;
+    long offset = 0;
+    while (std::fseek(log, offset, SEEK_SET) == 0 && std::fread(&header, sizeof(header), 1, log) == 1 &&
+           std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0) {
+        entries.push_back({uint32_t(offset), header.firstTime, header.lastTime});
+        offset += (sizeof(header) + header.storedSize + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    }
+    return entries;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <log file> [from ms] [to ms]\n", argv[0]);
+        return 1;
+    }
+    FILE* log = std::fopen(argv[1], "rb");
+    if (log == nullptr) {
+        std::fprintf(stderr, "could not open %s\n", argv[1]);
+        return 1;
+    }
+    const uint32_t from = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 0;
+    const uint32_t to = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : UINT32_MAX;
+
+    int read = 0;
+    int corrupt = 0;
+    for (const IndexEntry& entry : findSegments(log, argv[1])) {
+        if (entry.lastTime < from || entry.firstTime > to) continue;
+        SegmentHeader header;
+        if (std::fseek(log, entry.offset, SEEK_SET) != 0 || std::fread(&header, sizeof(header), 1, log) != 1 ||
+            std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+            corrupt++;
+            continue;
+        }
+        std::vector<uint8_t> data(header.storedSize);
+        if (std::fread(data.data(), 1, data.size(), log) != data.size()) {
+            corrupt++;
+            continue;
+        }
+        if (header.flags & COMPRESSED) {
+            const std::optional<std::vector<uint8_t>> decompressed =
+                lemlib::lz4Decompress(data.data(), data.size(), header.size);
+            if (!decompressed) {
+                corrupt++;
+                continue;
+            }
+            data = *decompressed;
+        }
+        std::fwrite(data.data(), 1, data.size(), stdout);
+        read++;
+    }
+    std::fclose(log);
+    std::fprintf(stderr, "%d segments, %d corrupt\n", read, corrupt);
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * Merges logs and telemetry into a single timeline, ordered by the time each record was logged
+ *
+ * Usage: merge <file>...
+ *
+ * Each file is either a CSV file written by sim/build/decode, with the time in microseconds in its first column, or a
+ * text log whose lines start with the time in microseconds, like the ones written by lemlib::FileSink and printed by
+ * sim/build/logcat. Every record is printed on its own line with its time, the time since the previous record, and the
+ * name of the file it came from, so the latency between the two can be read off directly. Records logged at the same
+ * time stay in the order they were in their files.
+ */
+
+/**
+ * @brief A line of one of the files
+ */
+struct Record {
+        uint64_t micros;
+        /** name of the file, without its directory or extension */
+        std::string source;
+        /** the rest of the line */
+        std::string text;
+};
+
+/**
+ * @brief Get the name of a file without its directory or extension
+ */
+static std::string sourceName(const std::string& path) {
+    const size_t slash = path.find_last_of('/');
+    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+    const size_t dot = name.find_last_of('.');
+    return dot == std::string::npos ? name : name.substr(0, dot);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <file>...\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<Record> records;
+    for (int i = 1; i < argc; i++) {
+        std::ifstream input(argv[i]);
+        if (!input) {
+            std::fprintf(stderr, "could not open %s\n", argv[i]);
+            return 1;
+        }
+        const std::string source = sourceName(argv[i]);
+        int skipped = 0;
+        std::string line;
+        bool first = true;
+        while (std::getline(input, line)) {
+            // the header of a CSV file
+            if (first && line.rfind("time_us", 0) == 0) {
+                first = false;
+                continue;
+            }
+            first = false;
+            char* end;
+            const uint64_t micros = std::strtoull(line.c_str(), &end, 10);
+            if (end == line.c_str() || (*end != ',' && *end != ' ')) {
+                skipped++;
+                continue;
+            }
+            records.push_back({micros, source, std::string(end + 1)});
+        }
+        if (skipped > 0) std::fprintf(stderr, "%s: skipped %d lines without a time\n", argv[i], skipped);
+    }
+
+    // stable, so records logged at the same time stay in order
+    std::stable_sort(records.begin(), records.end(),
+                     [](const Record& a, const Record& b) { return a.micros < b.micros; });
+
+    uint64_t last = records.empty() ? 0 : records.front().micros;
+    for (const Record& record : records) {
+        std::printf("%12llu %+10lld %-16s %s\n", (unsigned long long)record.micros, (long long)(record.micros - last),
+                    record.source.c_str(), record.text.c_str());
+        last = record.micros;
+    }
+    return 0;
+}
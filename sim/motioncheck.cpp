@@ -0,0 +1,66 @@
+#include <cstdio>
+#include <unistd.h>
+#include "lemlib/api.hpp" // IWYU pragma: keep
+#include "sim.hpp"
+
+/**
+ * Checks how motions hand off to each other, on a simulated copy of the robot in src/main.cpp
+ *
+ * Usage: motioncheck
+ *
+ * Every check prints whether it passed. Exits with 1 if any check failed
+ */
+
+pros::MotorGroup leftMotors({8, 10, 14}, pros::MotorGearset::blue);
+pros::MotorGroup rightMotors({-1, -2, -3}, pros::MotorGearset::blue);
+pros::Imu imu(9);
+
+lemlib::Drivetrain drivetrain(&leftMotors, &rightMotors, 12, lemlib::Omniwheel::NEW_325, 450, 2);
+lemlib::ControllerSettings linearController(10, 0, 3, 3, 1, 100, 3, 500, 20);
+lemlib::ControllerSettings angularController(2, 0, 10, 3, 1, 100, 3, 500, 0);
+lemlib::OdomSensors sensors(nullptr, nullptr, nullptr, nullptr, &imu);
+lemlib::Chassis chassis(drivetrain, linearController, angularController, sensors);
+
+static int failures = 0;
+
+/**
+ * @brief Print the result of a check, and count it if it failed
+ *
+ * @param passed whether the check passed
+ * @param name what was checked
+ */
+static void check(bool passed, const char* name) {
+    std::printf("%s  %s\n", passed ? "pass" : "FAIL", name);
+    if (!passed) failures++;
+}
+
+int main() {
+    sim::configure({.leftPorts = {8, 10, 14}, .rightPorts = {-1, -2, -3}, .imuPort = 9});
+
+    sim::run([] { chassis.calibrate(); },
+             [] {
+                 chassis.setPose(0, 0, 0);
+                 // blend into a turn that is already done, so it exits straight away and stops the robot
+                 constexpr float blendSpeed = 80;
+                 chassis.moveToPoint(0, 48, 3000, {.minSpeed = blendSpeed, .earlyExitRange = 8, .blend = true});
+                 chassis.turnToHeading(0, 1000, {.minSpeed = 1, .earlyExitRange = 10});
+                 chassis.waitUntilDone();
+                 // the turn didn't blend into this motion, so it has to start from rest and slew up, even though the
+                 // handoff of the first motion is still recent. Inheriting it would start at the blend speed
+                 chassis.moveToPoint(0, 72, 2000);
+                 int32_t voltage = 0;
+                 for (int i = 0; i < 100 && voltage == 0; i++) {
+                     pros::delay(1);
+                     voltage = (leftMotors.get_voltage(0) + rightMotors.get_voltage(0)) / 2;
+                 }
+                 const float power = voltage * 127.0f / 12000;
+                 check(power > 0 && power < blendSpeed,
+                       "a motion doesn't inherit the handoff of a motion it didn't follow");
+                 chassis.waitUntilDone();
+             });
+
+    std::printf("%d checks failed\n", failures);
+    std::fflush(stdout);
+    // tasks started by the routine are still blocked in the scheduler, so don't wait for them
+    _exit(failures > 0 ? 1 : 0);
+}
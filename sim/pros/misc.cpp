@@ -0,0 +1,20 @@
+#include "pros/misc.hpp"
+#include "../world.hpp"
+
+/**
+ * Simulated brain and controller. The robot is always in autonomous, connected to a field controller
+ */
+
+extern "C" {
+int32_t controller_rumble(pros::controller_id_e_t, const char*) { return 1; }
+}
+
+namespace pros {
+namespace battery {
+int32_t get_voltage(void) { return sim::world::batteryVoltage() * 1000; }
+} // namespace battery
+
+namespace competition {
+std::uint8_t get_status(void) { return COMPETITION_AUTONOMOUS | COMPETITION_CONNECTED; }
+} // namespace competition
+} // namespace pros
@@ -0,0 +1,500 @@
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include "pros/error.h"
+#include "pros/motor_group.hpp"
+#include "../scheduler.hpp"
+#include "../world.hpp"
+
+/**
+ * Simulated smart motors. Only the parts of the motor API that make sense for a drivetrain are modelled. Movement
+ * functions that need the motor's own velocity or position controller apply 0 volts instead
+ */
+
+namespace {
+/**
+ * @brief Convert a position in rotations to the encoder units of a motor
+ *
+ * @param motor the motor
+ * @param rotations the position, in rotations
+ * @return double the position, in the encoder units of the motor
+ */
+double toUnits(const sim::world::Motor& motor, double rotations) {
+    switch (motor.units) {
+        case 1: return rotations;
+        case 2: {
+            // counts per rotation of the cartridge output
+            const double counts = motor.gearing == 0 ? 1800 : motor.gearing == 2 ? 300 : 900;
+            return rotations * counts;
+        }
+        default: return rotations * 360;
+    }
+}
+
+/**
+ * @brief Convert a position in the encoder units of a motor to rotations
+ *
+ * @param motor the motor
+ * @param position the position, in the encoder units of the motor
+ * @return double the position, in rotations
+ */
+double toRotations(const sim::world::Motor& motor, double position) { return position / toUnits(motor, 1); }
+
+/**
+ * @brief Apply a voltage to a motor
+ *
+ * @param motor the motor
+ * @param millivolts the voltage, in millivolts
+ */
+void moveVoltage(sim::world::Motor& motor, int32_t millivolts) {
+    motor.voltage = std::clamp(millivolts, -12000, 12000);
+    motor.braking = false;
+    // the motor holds where it was when it stops, not where it last braked
+    if (motor.voltage == 0) motor.holdPosition = motor.position;
+}
+
+/**
+ * @brief Stop a motor, using its brake mode
+ *
+ * @param motor the motor
+ */
+void brake(sim::world::Motor& motor) {
+    if (!motor.braking || motor.voltage != 0) motor.holdPosition = motor.position;
+    motor.voltage = 0;
+    motor.braking = true;
+}
+} // namespace
+
+extern "C" {
+int32_t motor_move_voltage(int8_t port, int32_t voltage) {
+    moveVoltage(sim::world::motor(port), voltage);
+    return 1;
+}
+
+int32_t motor_brake(int8_t port) {
+    brake(sim::world::motor(port));
+    return 1;
+}
+}
+
+namespace pros {
+inline namespace v5 {
+MotorGroup::MotorGroup(const std::initializer_list<std::int8_t> ports, const MotorGears gearset,
+                       const MotorUnits encoder_units)
+    : MotorGroup(std::vector<std::int8_t>(ports), gearset, encoder_units) {}
+
+MotorGroup::MotorGroup(const std::vector<std::int8_t>& ports, const MotorGears gearset, const MotorUnits encoder_units)
+    : _ports(ports) {
+    if (gearset != MotorGears::invalid) set_gearing_all(gearset);
+    if (encoder_units != MotorUnits::invalid) set_encoder_units_all(encoder_units);
+}
+
+MotorGroup::MotorGroup(AbstractMotor& motor_group)
+    : _ports(motor_group.get_port_all()) {}
+
+/**
+ * @brief Run a function on the motor at an index
+ *
+ * @param ports the ports of the motor group
+ * @param index the index of the motor
+ * @param error what to return if the index is out of range
+ * @param function the function, which is passed the motor
+ */
+template <typename T, typename F> static T atIndex(const std::vector<std::int8_t>& ports, std::uint8_t index, T error,
+                                                   F function) {
+    if (index >= ports.size()) {
+        errno = EOVERFLOW;
+        return error;
+    }
+    return function(sim::world::motor(ports[index]));
+}
+
+/**
+ * @brief Run a function on every motor, and collect what it returns
+ *
+ * @param ports the ports of the motor group
+ * @param function the function, which is passed the motor
+ */
+template <typename F> static auto forAll(const std::vector<std::int8_t>& ports, F function) {
+    std::vector<decltype(function(sim::world::motor(1)))> out;
+    for (std::int8_t port : ports) out.push_back(function(sim::world::motor(port)));
+    return out;
+}
+
+/**
+ * @brief Run a function on every motor
+ *
+ * @param ports the ports of the motor group
+ * @param function the function, which is passed the motor
+ */
+template <typename F> static std::int32_t setAll(const std::vector<std::int8_t>& ports, F function) {
+    for (std::int8_t port : ports) function(sim::world::motor(port));
+    return 1;
+}
+
+std::int32_t MotorGroup::move(std::int32_t voltage) const {
+    return move_voltage(std::clamp(voltage, -127, 127) * 12000 / 127);
+}
+
+std::int32_t MotorGroup::move_absolute(const double, const std::int32_t) const { return move_voltage(0); }
+
+std::int32_t MotorGroup::move_relative(const double, const std::int32_t) const { return move_voltage(0); }
+
+std::int32_t MotorGroup::move_velocity(const std::int32_t) const { return move_voltage(0); }
+
+std::int32_t MotorGroup::move_voltage(const std::int32_t voltage) const {
+    return setAll(_ports, [&](sim::world::Motor& motor) { moveVoltage(motor, voltage); });
+}
+
+std::int32_t MotorGroup::brake(void) const {
+    return setAll(_ports, [](sim::world::Motor& motor) { ::brake(motor); });
+}
+
+std::int32_t MotorGroup::modify_profiled_velocity(const std::int32_t) const { return 1; }
+
+double MotorGroup::get_target_position(const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR_F, [](sim::world::Motor&) { return 0.0; });
+}
+
+std::vector<double> MotorGroup::get_target_position_all(void) const {
+    return forAll(_ports, [](sim::world::Motor&) { return 0.0; });
+}
+
+std::int32_t MotorGroup::get_target_velocity(const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR, [](sim::world::Motor&) { return 0; });
+}
+
+std::vector<std::int32_t> MotorGroup::get_target_velocity_all(void) const {
+    return forAll(_ports, [](sim::world::Motor&) { return 0; });
+}
+
+double MotorGroup::get_actual_velocity(const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR_F, [](sim::world::Motor& motor) { return motor.velocity; });
+}
+
+std::vector<double> MotorGroup::get_actual_velocity_all(void) const {
+    return forAll(_ports, [](sim::world::Motor& motor) { return motor.velocity; });
+}
+
+std::int32_t MotorGroup::get_current_draw(const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR,
+                   [](sim::world::Motor& motor) { return std::int32_t(std::fabs(motor.current) * 1000); });
+}
+
+std::vector<std::int32_t> MotorGroup::get_current_draw_all(void) const {
+    return forAll(_ports, [](sim::world::Motor& motor) { return std::int32_t(std::fabs(motor.current) * 1000); });
+}
+
+std::int32_t MotorGroup::get_direction(const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR, [](sim::world::Motor& motor) { return motor.velocity < 0 ? -1 : 1; });
+}
+
+std::vector<std::int32_t> MotorGroup::get_direction_all(void) const {
+    return forAll(_ports, [](sim::world::Motor& motor) { return motor.velocity < 0 ? -1 : 1; });
+}
+
+double MotorGroup::get_efficiency(const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR_F, [](sim::world::Motor&) { return 100.0; });
+}
+
+std::vector<double> MotorGroup::get_efficiency_all(void) const {
+    return forAll(_ports, [](sim::world::Motor&) { return 100.0; });
+}
+
+std::uint32_t MotorGroup::get_faults(const std::uint8_t index) const {
+    return atIndex(_ports, index, std::uint32_t(PROS_ERR), [](sim::world::Motor&) { return std::uint32_t(0); });
+}
+
+std::vector<std::uint32_t> MotorGroup::get_faults_all(void) const {
+    return forAll(_ports, [](sim::world::Motor&) { return std::uint32_t(0); });
+}
+
+std::uint32_t MotorGroup::get_flags(const std::uint8_t index) const {
+    return atIndex(_ports, index, std::uint32_t(PROS_ERR), [](sim::world::Motor&) { return std::uint32_t(0); });
+}
+
+std::vector<std::uint32_t> MotorGroup::get_flags_all(void) const {
+    return forAll(_ports, [](sim::world::Motor&) { return std::uint32_t(0); });
+}
+
+double MotorGroup::get_position(const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR_F,
+                   [](sim::world::Motor& motor) { return toUnits(motor, motor.position - motor.zero); });
+}
+
+std::vector<double> MotorGroup::get_position_all(void) const {
+    return forAll(_ports, [](sim::world::Motor& motor) { return toUnits(motor, motor.position - motor.zero); });
+}
+
+double MotorGroup::get_power(const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR_F,
+                   [](sim::world::Motor& motor) { return std::fabs(motor.voltage / 1000.0 * motor.current); });
+}
+
+std::vector<double> MotorGroup::get_power_all(void) const {
+    return forAll(_ports, [](sim::world::Motor& motor) { return std::fabs(motor.voltage / 1000.0 * motor.current); });
+}
+
+std::int32_t MotorGroup::get_raw_position(std::uint32_t* const timestamp, const std::uint8_t index) const {
+    if (timestamp != nullptr) *timestamp = sim::scheduler::micros() / 1000;
+    return atIndex(_ports, index, PROS_ERR, [](sim::world::Motor& motor) {
+        const double counts = motor.gearing == 0 ? 1800 : motor.gearing == 2 ? 300 : 900;
+        return std::int32_t(motor.position * counts);
+    });
+}
+
+std::vector<std::int32_t> MotorGroup::get_raw_position_all(std::uint32_t* const timestamp) const {
+    std::vector<std::int32_t> out;
+    for (std::uint8_t i = 0; i < _ports.size(); i++) out.push_back(get_raw_position(timestamp, i));
+    return out;
+}
+
+double MotorGroup::get_temperature(const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR_F, [](sim::world::Motor&) { return 25.0; });
+}
+
+std::vector<double> MotorGroup::get_temperature_all(void) const {
+    return forAll(_ports, [](sim::world::Motor&) { return 25.0; });
+}
+
+double MotorGroup::get_torque(const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR_F, [](sim::world::Motor& motor) { return motor.current * 0.84 / 2.5; });
+}
+
+std::vector<double> MotorGroup::get_torque_all(void) const {
+    return forAll(_ports, [](sim::world::Motor& motor) { return motor.current * 0.84 / 2.5; });
+}
+
+std::int32_t MotorGroup::get_voltage(const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR, [](sim::world::Motor& motor) { return motor.voltage; });
+}
+
+std::vector<std::int32_t> MotorGroup::get_voltage_all(void) const {
+    return forAll(_ports, [](sim::world::Motor& motor) { return motor.voltage; });
+}
+
+std::int32_t MotorGroup::is_over_current(const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR, [](sim::world::Motor& motor) {
+        return std::int32_t(std::fabs(motor.current) * 1000 >= motor.currentLimit);
+    });
+}
+
+std::vector<std::int32_t> MotorGroup::is_over_current_all(void) const {
+    return forAll(_ports, [](sim::world::Motor& motor) {
+        return std::int32_t(std::fabs(motor.current) * 1000 >= motor.currentLimit);
+    });
+}
+
+std::int32_t MotorGroup::is_over_temp(const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR, [](sim::world::Motor&) { return 0; });
+}
+
+std::vector<std::int32_t> MotorGroup::is_over_temp_all(void) const {
+    return forAll(_ports, [](sim::world::Motor&) { return 0; });
+}
+
+MotorBrake MotorGroup::get_brake_mode(const std::uint8_t index) const {
+    return atIndex(_ports, index, MotorBrake::invalid,
+                   [](sim::world::Motor& motor) { return MotorBrake(motor.brakeMode); });
+}
+
+std::vector<MotorBrake> MotorGroup::get_brake_mode_all(void) const {
+    return forAll(_ports, [](sim::world::Motor& motor) { return MotorBrake(motor.brakeMode); });
+}
+
+std::int32_t MotorGroup::get_current_limit(const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR, [](sim::world::Motor& motor) { return motor.currentLimit; });
+}
+
+std::vector<std::int32_t> MotorGroup::get_current_limit_all(void) const {
+    return forAll(_ports, [](sim::world::Motor& motor) { return motor.currentLimit; });
+}
+
+MotorUnits MotorGroup::get_encoder_units(const std::uint8_t index) const {
+    return atIndex(_ports, index, MotorUnits::invalid,
+                   [](sim::world::Motor& motor) { return MotorUnits(motor.units); });
+}
+
+std::vector<MotorUnits> MotorGroup::get_encoder_units_all(void) const {
+    return forAll(_ports, [](sim::world::Motor& motor) { return MotorUnits(motor.units); });
+}
+
+MotorGears MotorGroup::get_gearing(const std::uint8_t index) const {
+    return atIndex(_ports, index, MotorGears::invalid,
+                   [](sim::world::Motor& motor) { return MotorGears(motor.gearing); });
+}
+
+std::vector<MotorGears> MotorGroup::get_gearing_all(void) const {
+    return forAll(_ports, [](sim::world::Motor& motor) { return MotorGears(motor.gearing); });
+}
+
+std::vector<std::int8_t> MotorGroup::get_port_all(void) const { return _ports; }
+
+std::int32_t MotorGroup::get_voltage_limit(const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR, [](sim::world::Motor& motor) { return motor.voltageLimit; });
+}
+
+std::vector<std::int32_t> MotorGroup::get_voltage_limit_all(void) const {
+    return forAll(_ports, [](sim::world::Motor& motor) { return motor.voltageLimit; });
+}
+
+std::int32_t MotorGroup::is_reversed(const std::uint8_t index) const {
+    if (index >= _ports.size()) {
+        errno = EOVERFLOW;
+        return PROS_ERR;
+    }
+    return _ports[index] < 0;
+}
+
+std::vector<std::int32_t> MotorGroup::is_reversed_all(void) const {
+    std::vector<std::int32_t> out;
+    for (std::int8_t port : _ports) out.push_back(port < 0);
+    return out;
+}
+
+MotorType MotorGroup::get_type(const std::uint8_t index) const {
+    return atIndex(_ports, index, MotorType::invalid, [](sim::world::Motor&) { return MotorType::v5; });
+}
+
+std::vector<MotorType> MotorGroup::get_type_all(void) const {
+    return forAll(_ports, [](sim::world::Motor&) { return MotorType::v5; });
+}
+
+std::int32_t MotorGroup::set_brake_mode(const MotorBrake mode, const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR, [&](sim::world::Motor& motor) {
+        motor.brakeMode = int(mode);
+        return 1;
+    });
+}
+
+std::int32_t MotorGroup::set_brake_mode(const pros::motor_brake_mode_e_t mode, const std::uint8_t index) const {
+    return set_brake_mode(MotorBrake(mode), index);
+}
+
+std::int32_t MotorGroup::set_brake_mode_all(const MotorBrake mode) const {
+    return setAll(_ports, [&](sim::world::Motor& motor) { motor.brakeMode = int(mode); });
+}
+
+std::int32_t MotorGroup::set_brake_mode_all(const pros::motor_brake_mode_e_t mode) const {
+    return set_brake_mode_all(MotorBrake(mode));
+}
+
+std::int32_t MotorGroup::set_current_limit(const std::int32_t limit, const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR, [&](sim::world::Motor& motor) {
+        motor.currentLimit = std::clamp(limit, 0, 2500);
+        return 1;
+    });
+}
+
+std::int32_t MotorGroup::set_current_limit_all(const std::int32_t limit) const {
+    return setAll(_ports, [&](sim::world::Motor& motor) { motor.currentLimit = std::clamp(limit, 0, 2500); });
+}
+
+std::int32_t MotorGroup::set_encoder_units(const MotorUnits units, const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR, [&](sim::world::Motor& motor) {
+        motor.units = int(units);
+        return 1;
+    });
+}
+
+std::int32_t MotorGroup::set_encoder_units(const pros::motor_encoder_units_e_t units, const std::uint8_t index) const {
+    return set_encoder_units(MotorUnits(units), index);
+}
+
+std::int32_t MotorGroup::set_encoder_units_all(const MotorUnits units) const {
+    return setAll(_ports, [&](sim::world::Motor& motor) { motor.units = int(units); });
+}
+
+std::int32_t MotorGroup::set_encoder_units_all(const pros::motor_encoder_units_e_t units) const {
+    return set_encoder_units_all(MotorUnits(units));
+}
+
+std::int32_t MotorGroup::set_gearing(std::vector<pros::motor_gearset_e_t> gearsets) const {
+    for (std::uint8_t i = 0; i < std::min(gearsets.size(), _ports.size()); i++) set_gearing(gearsets[i], i);
+    return 1;
+}
+
+std::int32_t MotorGroup::set_gearing(const pros::motor_gearset_e_t gearset, const std::uint8_t index) const {
+    return set_gearing(MotorGears(gearset), index);
+}
+
+std::int32_t MotorGroup::set_gearing(std::vector<MotorGears> gearsets) const {
+    for (std::uint8_t i = 0; i < std::min(gearsets.size(), _ports.size()); i++) set_gearing(gearsets[i], i);
+    return 1;
+}
+
+std::int32_t MotorGroup::set_gearing(const MotorGears gearset, const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR, [&](sim::world::Motor& motor) {
+        motor.gearing = int(gearset);
+        return 1;
+    });
+}
+
+std::int32_t MotorGroup::set_gearing_all(const MotorGears gearset) const {
+    return setAll(_ports, [&](sim::world::Motor& motor) { motor.gearing = int(gearset); });
+}
+
+std::int32_t MotorGroup::set_gearing_all(const pros::motor_gearset_e_t gearset) const {
+    return set_gearing_all(MotorGears(gearset));
+}
+
+std::int32_t MotorGroup::set_reversed(const bool reverse, const std::uint8_t index) {
+    if (index >= _ports.size()) {
+        errno = EOVERFLOW;
+        return PROS_ERR;
+    }
+    _ports[index] = reverse ? -std::abs(_ports[index]) : std::abs(_ports[index]);
+    return 1;
+}
+
+std::int32_t MotorGroup::set_reversed_all(const bool reverse) {
+    for (std::uint8_t i = 0; i < _ports.size(); i++) set_reversed(reverse, i);
+    return 1;
+}
+
+std::int32_t MotorGroup::set_voltage_limit(const std::int32_t limit, const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR, [&](sim::world::Motor& motor) {
+        motor.voltageLimit = std::clamp(limit, 0, 12000);
+        return 1;
+    });
+}
+
+std::int32_t MotorGroup::set_voltage_limit_all(const std::int32_t limit) const {
+    return setAll(_ports, [&](sim::world::Motor& motor) { motor.voltageLimit = std::clamp(limit, 0, 12000); });
+}
+
+std::int32_t MotorGroup::set_zero_position(const double position, const std::uint8_t index) const {
+    return atIndex(_ports, index, PROS_ERR, [&](sim::world::Motor& motor) {
+        motor.zero = motor.position - toRotations(motor, position);
+        return 1;
+    });
+}
+
+std::int32_t MotorGroup::set_zero_position_all(const double position) const {
+    return setAll(_ports,
+                  [&](sim::world::Motor& motor) { motor.zero = motor.position - toRotations(motor, position); });
+}
+
+std::int32_t MotorGroup::tare_position(const std::uint8_t index) const { return set_zero_position(0, index); }
+
+std::int32_t MotorGroup::tare_position_all(void) const { return set_zero_position_all(0); }
+
+std::int8_t MotorGroup::size(void) const { return _ports.size(); }
+
+std::int8_t MotorGroup::get_port(const std::uint8_t index) const {
+    if (index >= _ports.size()) {
+        errno = EOVERFLOW;
+        return PROS_ERR_BYTE;
+    }
+    return _ports[index];
+}
+
+void MotorGroup::operator+=(AbstractMotor& other) { append(other); }
+
+void MotorGroup::append(AbstractMotor& other) {
+    for (std::int8_t port : other.get_port_all()) _ports.push_back(port);
+}
+
+void MotorGroup::erase_port(std::int8_t port) { std::erase(_ports, port); }
+} // namespace v5
+} // namespace pros
@@ -0,0 +1,52 @@
+#include "pros/rtos.hpp"
+#include "../scheduler.hpp"
+
+/**
+ * Simulated RTOS. Tasks run on the cooperative scheduler, and time is the simulated clock. Since only one task runs at
+ * a time and tasks only switch when they delay, a mutex is just a flag that tasks wait on by delaying
+ */
+
+extern "C" {
+uint32_t millis(void) { return sim::scheduler::micros() / 1000; }
+
+uint64_t micros(void) { return sim::scheduler::micros(); }
+
+void delay(const uint32_t milliseconds) { sim::scheduler::delay(milliseconds); }
+}
+
+namespace pros {
+inline namespace rtos {
+Task::Task(task_fn_t function, void* parameters, std::uint32_t prio, std::uint16_t, const char*) {
+    task = sim::scheduler::createTask([function, parameters] { function(parameters); }, prio);
+}
+
+mutex_t Mutex::lazy_init() {
+    mutex_t current = mutex.load();
+    if (current != nullptr) return current;
+    // the mutex handle points to whether the mutex is taken
+    mutex_t created = new bool(false);
+    mutex.store(created);
+    return created;
+}
+
+bool Mutex::take() { return take(TIMEOUT_MAX); }
+
+bool Mutex::take(std::uint32_t timeout) {
+    bool* taken = static_cast<bool*>(lazy_init());
+    const uint64_t start = sim::scheduler::micros();
+    while (*taken) {
+        if (timeout != TIMEOUT_MAX && sim::scheduler::micros() - start >= uint64_t(timeout) * 1000) return false;
+        sim::scheduler::delay(1);
+    }
+    *taken = true;
+    return true;
+}
+
+bool Mutex::give() {
+    *static_cast<bool*>(lazy_init()) = false;
+    return true;
+}
+
+Mutex::~Mutex() { delete static_cast<bool*>(mutex.load()); }
+} // namespace rtos
+} // namespace pros
@@ -0,0 +1,153 @@
+#include <cmath>
+#include "pros/adi.hpp"
+#include "pros/imu.hpp"
+#include "pros/rotation.hpp"
+#include "../scheduler.hpp"
+#include "../world.hpp"
+
+/**
+ * Simulated sensors. Inertial sensors measure the heading of the robot, and rotation sensors measure the tracking
+ * wheels set up in sim::RobotConfig. Sensors are assumed to be reversed correctly in code, like the motors
+ */
+
+namespace pros {
+inline namespace v5 {
+Device::Device(const std::uint8_t port)
+    : _port(port) {}
+
+std::uint8_t Device::get_port(void) const { return _port; }
+
+bool Device::is_installed() { return true; }
+
+/**
+ * @brief Get the rotation an inertial sensor measures
+ *
+ * @param port the port of the sensor
+ * @return double rotation, in degrees
+ */
+static double imuRotation(std::uint8_t port) { return sim::world::imuRotation() - sim::world::imu(port).offset; }
+
+/**
+ * @brief Check whether an inertial sensor is calibrating
+ *
+ * @param port the port of the sensor
+ */
+static bool imuCalibrating(std::uint8_t port) {
+    return sim::scheduler::micros() < sim::world::imu(port).calibrationEnd;
+}
+
+std::int32_t Imu::reset(bool blocking) const {
+    sim::world::Imu& imu = sim::world::imu(_port);
+    imu.offset = sim::world::imuRotation();
+    imu.calibrationEnd = sim::scheduler::micros() + 2000000;
+    while (blocking && imuCalibrating(_port)) sim::scheduler::delay(10);
+    return 1;
+}
+
+std::int32_t Imu::set_data_rate(std::uint32_t) const { return 1; }
+
+double Imu::get_rotation() const { return imuRotation(_port); }
+
+double Imu::get_heading() const {
+    const double heading = std::fmod(imuRotation(_port), 360);
+    return heading < 0 ? heading + 360 : heading;
+}
+
+pros::quaternion_s_t Imu::get_quaternion() const {
+    // rotation about the z axis only, counterclockwise positive
+    const double yaw = -get_yaw() * M_PI / 180;
+    return {0, 0, std::sin(yaw / 2), std::cos(yaw / 2)};
+}
+
+pros::euler_s_t Imu::get_euler() const { return {0, 0, get_yaw()}; }
+
+double Imu::get_pitch() const { return 0; }
+
+double Imu::get_roll() const { return 0; }
+
+double Imu::get_yaw() const {
+    const double heading = get_heading();
+    return heading >= 180 ? heading - 360 : heading;
+}
+
+pros::imu_gyro_s_t Imu::get_gyro_rate() const { return {0, 0, 0}; }
+
+std::int32_t Imu::tare_rotation() const { return set_rotation(0); }
+
+std::int32_t Imu::tare_heading() const { return set_heading(0); }
+
+std::int32_t Imu::tare_pitch() const { return 1; }
+
+std::int32_t Imu::tare_yaw() const { return set_heading(0); }
+
+std::int32_t Imu::tare_roll() const { return 1; }
+
+std::int32_t Imu::tare() const { return set_rotation(0); }
+
+std::int32_t Imu::tare_euler() const { return set_heading(0); }
+
+std::int32_t Imu::set_heading(const double target) const {
+    return set_rotation(imuRotation(_port) - get_heading() + target);
+}
+
+std::int32_t Imu::set_rotation(const double target) const {
+    sim::world::imu(_port).offset = sim::world::imuRotation() - target;
+    return 1;
+}
+
+std::int32_t Imu::set_yaw(const double target) const { return set_heading(target); }
+
+std::int32_t Imu::set_pitch(const double) const { return 1; }
+
+std::int32_t Imu::set_roll(const double) const { return 1; }
+
+std::int32_t Imu::set_euler(const pros::euler_s_t target) const { return set_heading(target.yaw); }
+
+pros::imu_accel_s_t Imu::get_accel() const { return {0, 0, 1}; }
+
+pros::ImuStatus Imu::get_status() const {
+    return imuCalibrating(_port) ? pros::ImuStatus::calibrating : pros::ImuStatus::ready;
+}
+
+bool Imu::is_calibrating() const { return imuCalibrating(_port); }
+
+imu_orientation_e_t Imu::get_physical_orientation() const { return E_IMU_Z_UP; }
+
+Rotation::Rotation(const std::int8_t port)
+    : Device(std::abs(port), DeviceType::rotation) {}
+
+std::int32_t Rotation::reset() { return reset_position(); }
+
+std::int32_t Rotation::set_data_rate(std::uint32_t) const { return 1; }
+
+std::int32_t Rotation::set_position(std::int32_t position) const {
+    sim::world::rotation(_port).position = position;
+    return 1;
+}
+
+std::int32_t Rotation::reset_position(void) const { return set_position(0); }
+
+std::int32_t Rotation::get_position() const { return std::lround(sim::world::rotation(_port).position); }
+
+std::int32_t Rotation::get_velocity() const { return std::lround(sim::world::rotation(_port).velocity); }
+
+std::int32_t Rotation::get_angle() const {
+    const std::int32_t angle = get_position() % 36000;
+    return angle < 0 ? angle + 36000 : angle;
+}
+
+std::int32_t Rotation::set_reversed(bool) const { return 1; }
+
+std::int32_t Rotation::reverse() const { return 1; }
+
+std::int32_t Rotation::get_reversed() const { return 0; }
+} // namespace v5
+
+namespace adi {
+// ADI encoders aren't simulated, so tracking wheels in the simulator have to use rotation sensors
+
+std::int32_t Encoder::reset() const { return 1; }
+
+std::int32_t Encoder::get_value() const { return 0; }
+} // namespace adi
+} // namespace pros
@@ -0,0 +1,50 @@
+#include <cmath>
+#include "lemlib/chassis/odom.hpp"
+#include "scheduler.hpp"
+#include "world.hpp"
+
+namespace sim {
+void configure(const RobotConfig& config, lemlib::Pose start) { world::configure(config, start); }
+
+Report run(const std::function<void()>& initialize, const std::function<void()>& autonomous, uint32_t timeLimit) {
+    // the calling thread supervises the routine, which runs in a task of its own
+    scheduler::adoptCurrentThread();
+    scheduler::setStepFunction(world::step);
+    Report report;
+    bool started = false;
+    bool finished = false;
+    uint64_t startTime = 0;
+    uint64_t endTime = 0;
+    scheduler::createTask([&] {
+        initialize();
+        world::startReport();
+        startTime = scheduler::micros();
+        started = true;
+        autonomous();
+        endTime = scheduler::micros();
+        finished = true;
+    });
+
+    // odometry is compared to the actual pose every iteration of the chassis
+    while (!finished) {
+        scheduler::delay(10);
+        if (!started) continue;
+        report.finalOdomError = lemlib::getPose().distance(world::pose());
+        report.maxOdomError = std::fmax(report.maxOdomError, report.finalOdomError);
+        if (scheduler::micros() - startTime >= uint64_t(timeLimit) * 1000) {
+            report.timedOut = true;
+            endTime = scheduler::micros();
+            break;
+        }
+    }
+
+    world::finishReport(report);
+    report.duration = (endTime - startTime) / 1e6;
+    report.finalOdomError = lemlib::getPose().distance(report.finalPose);
+    return report;
+}
+
+void setTarget(float x, float y) { world::setTarget(x, y); }
+
+lemlib::Pose getTruePose() { return world::pose(); }
+} // namespace sim
@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "scheduler.hpp"
+
+namespace sim::scheduler {
+/**
+ * @brief A simulated task
+ */
+struct Task {
+        /** id of the task, in order of creation */
+        int id;
+        /** when the task should run next, in microseconds */
+        uint64_t wakeTime;
+        /** higher priority tasks run first when several are ready */
+        uint32_t priority;
+        /** the function the task runs */
+        std::function<void()> function;
+        /** whether the function of the task has returned */
+        bool done = false;
+};
+
+// only the thread whose task is current is allowed to run, the rest wait on the condition variable
+static std::mutex lock;
+static std::condition_variable switched;
+static std::vector<std::unique_ptr<Task>> tasks;
+static Task* current = nullptr;
+static bool adopted = false;
+static uint64_t now = 0;
+static std::function<void(float)> stepPhysics;
+
+// the physics is stepped at 1 kHz
+constexpr uint64_t PHYSICS_STEP = 1000;
+// TASK_PRIORITY_DEFAULT of PROS
+constexpr uint32_t DEFAULT_PRIORITY = 8;
+
+/**
+ * @brief Switch to the task that should run next, advancing the clock if needed
+ *
+ * @param guard the held scheduler lock
+ */
+static void switchTask(std::unique_lock<std::mutex>& guard) {
+    Task* self = current;
+    // if no task is ready yet, the clock jumps forward to the first one that wakes up
+    uint64_t readyTime = UINT64_MAX;
+    for (const std::unique_ptr<Task>& task : tasks) {
+        if (!task->done) readyTime = std::min(readyTime, task->wakeTime);
+    }
+    if (readyTime == UINT64_MAX) return;
+    readyTime = std::max(readyTime, now);
+    // of the tasks that are ready, pick the one with the highest priority, then the one that woke up first. Ties go to
+    // the first task after the current one, so tasks that delay for the same time take turns
+    Task* next = nullptr;
+    const size_t start = self == nullptr ? 0 : self->id + 1;
+    for (size_t i = 0; i < tasks.size(); i++) {
+        Task* task = tasks[(start + i) % tasks.size()].get();
+        if (task->done || task->wakeTime > readyTime) continue;
+        if (next == nullptr || task->priority > next->priority ||
+            (task->priority == next->priority && task->wakeTime < next->wakeTime))
+            next = task;
+    }
+    // nothing is ready yet, so jump forward to when the next task wakes up
+    while (now < next->wakeTime) {
+        const uint64_t step = std::min(PHYSICS_STEP, next->wakeTime - now);
+        now += step;
+        if (stepPhysics) stepPhysics(step / 1e6f);
+    }
+    current = next;
+    switched.notify_all();
+    if (self == nullptr || self->done) return;
+    switched.wait(guard, [self] { return current == self; });
+}
+
+/**
+ * @brief Start the thread of a task
+ *
+ * @param task the task
+ */
+static void startThread(Task* task) {
+    std::thread([task] {
+        {
+            std::unique_lock guard(lock);
+            switched.wait(guard, [task] { return current == task; });
+        }
+        task->function();
+        std::unique_lock guard(lock);
+        task->done = true;
+        switchTask(guard);
+    }).detach();
+}
+
+void adoptCurrentThread() {
+    std::lock_guard guard(lock);
+    tasks.push_back(std::make_unique<Task>(Task {int(tasks.size()), now, DEFAULT_PRIORITY}));
+    current = tasks.back().get();
+    adopted = true;
+    // tasks created by static constructors only get threads now, so a process can fork before it starts simulating
+    for (const std::unique_ptr<Task>& task : tasks) {
+        if (task.get() != current) startThread(task.get());
+    }
+}
+
+void* createTask(std::function<void()> function, uint32_t priority) {
+    std::lock_guard guard(lock);
+    tasks.push_back(std::make_unique<Task>(Task {int(tasks.size()), now, priority, std::move(function)}));
+    Task* task = tasks.back().get();
+    if (adopted) startThread(task);
+    return task;
+}
+
+void delay(uint32_t milliseconds) {
+    std::unique_lock guard(lock);
+    // a delay of 0 still lets other ready tasks run
+    current->wakeTime = now + uint64_t(milliseconds) * 1000;
+    switchTask(guard);
+}
+
+uint64_t micros() { return now; }
+
+void setStepFunction(std::function<void(float)> step) {
+    std::lock_guard guard(lock);
+    stepPhysics = std::move(step);
+}
+} // namespace sim::scheduler
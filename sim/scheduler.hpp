@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace sim {
+/**
+ * @brief Cooperative scheduler that runs PROS tasks against a simulated clock
+ *
+ * Every task gets its own thread, but only one of them runs at a time, like on the single core of the V5 brain. A task
+ * runs until it delays, then the scheduler switches to the ready task with the highest priority, or the one that woke
+ * up first if several have the same priority. If no task is ready, the clock jumps forward to the next wake up,
+ * stepping the physics on the way, so simulated time passes as fast as the host can compute it. Tasks that wake up at
+ * the same time with the same priority take turns in a fixed order, which makes every run deterministic.
+ *
+ * Tasks aren't preempted, so a higher priority task that wakes up while another task is running waits for it to delay
+ */
+namespace scheduler {
+/**
+ * @brief Make the calling thread a task, and start the threads of the tasks created so far
+ *
+ * Tasks created before this is called don't get a thread until it is, so a process can still safely fork. The calling
+ * thread gets the default priority
+ */
+void adoptCurrentThread();
+/**
+ * @brief Create a task, which will start running the next time the current task delays
+ *
+ * @param function the function the task runs
+ * @param priority priority of the task, from 1 to 16 like a PROS task. The default PROS priority, 8, by default
+ * @return void* handle of the task
+ */
+void* createTask(std::function<void()> function, uint32_t priority = 8);
+/**
+ * @brief Suspend the current task for some time
+ *
+ * @param milliseconds how long to suspend the task for
+ */
+void delay(uint32_t milliseconds);
+/**
+ * @brief Get the simulated time
+ *
+ * @return uint64_t time since the simulation started, in microseconds
+ */
+uint64_t micros();
+/**
+ * @brief Set the function that steps the physics, called every millisecond of simulated time
+ *
+ * @param step the function, which is passed the time step in seconds
+ */
+void setStepFunction(std::function<void(float)> step);
+} // namespace scheduler
+} // namespace sim
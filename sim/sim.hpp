@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "lemlib/pose.hpp"
+
+/**
+ * @brief Host simulator for LemLib
+ *
+ * The simulator links the LemLib sources against a simulated PROS layer. Motors follow a DC motor model, the robot
+ * follows a differential drive model, and sensors read the simulated robot. Time is simulated too, so a 15 second
+ * autonomous finishes in a fraction of a second. See sim/README.md for how to build and run it.
+ */
+namespace sim {
+/**
+ * @brief A tracking wheel read by a rotation sensor
+ */
+struct TrackingWheelConfig {
+        /** port of the rotation sensor */
+        int8_t port;
+        /** diameter of the wheel, in inches */
+        float diameter;
+        /** offset from the tracking center, in inches. Same convention as lemlib::TrackingWheel */
+        float offset;
+        /** true if the wheel measures forwards movement, false if it measures sideways movement */
+        bool vertical;
+};
+
+/**
+ * @brief Physical description of the simulated robot
+ *
+ * Motors are assumed to be reversed correctly in code, so positive voltage always drives a wheel forwards
+ */
+struct RobotConfig {
+        /** ports of the left drivetrain motors */
+        std::vector<int8_t> leftPorts;
+        /** ports of the right drivetrain motors */
+        std::vector<int8_t> rightPorts;
+        /** track width, in inches */
+        float trackWidth = 12;
+        /** diameter of the drive wheels, in inches */
+        float wheelDiameter = 3.25;
+        /** free speed of the drive wheels, in rpm */
+        float rpm = 450;
+        /** mass of the robot, in pounds */
+        float mass = 15;
+        /** length of the robot, in inches. Used for its moment of inertia */
+        float length = 15;
+        /** width of the robot, in inches. Used for its moment of inertia */
+        float width = 15;
+        /** height of the center of gravity, in inches. Used to tell how close the robot came to tipping over */
+        float cgHeight = 5;
+        /** friction coefficient between the wheels and the field. Limits how hard the robot can accelerate */
+        float traction = 1;
+        /** port of the inertial sensor. 0 if there isn't one */
+        uint8_t imuPort = 0;
+        /** how fast the inertial sensor drifts, in degrees per second */
+        float imuDrift = 0;
+        /** tracking wheels of the robot */
+        std::vector<TrackingWheelConfig> trackingWheels;
+        /** battery voltage, in volts */
+        float batteryVoltage = 12.6;
+};
+
+/**
+ * @brief What happened during a simulated run
+ */
+struct Report {
+        /** how long the autonomous routine took, in seconds */
+        float duration = 0;
+        /** whether the routine was stopped because it ran past the time limit */
+        bool timedOut = false;
+        /** where the robot actually ended up. x and y in inches, theta in degrees */
+        lemlib::Pose finalPose = lemlib::Pose(0, 0, 0);
+        /**
+         * largest distance between the actual and the odometry position, in inches. Only meaningful if the routine
+         * sets the pose of the chassis to the start pose passed to configure
+         */
+        float maxOdomError = 0;
+        /** distance between the actual and the odometry position at the end, in inches */
+        float finalOdomError = 0;
+        /** electrical energy used by the drivetrain motors, in joules */
+        float energy = 0;
+        /** average drivetrain motor voltage, as a fraction of 12 volts */
+        float effort = 0;
+        /** highest speed of the robot, in inches per second */
+        float maxSpeed = 0;
+        /** highest acceleration of the robot, in inches per second squared */
+        float maxAccel = 0;
+        /** highest acceleration as a fraction of the acceleration that would tip the robot over */
+        float tipping = 0;
+        /** furthest the robot went past a target set with setTarget, in inches */
+        float maxOvershoot = 0;
+};
+
+/**
+ * @brief Set up the simulated robot. Must be called before run
+ *
+ * @param config the robot
+ * @param start where the robot starts on the field. x and y in inches, theta in degrees
+ */
+void configure(const RobotConfig& config, lemlib::Pose start = lemlib::Pose(0, 0, 0));
+/**
+ * @brief Run a routine on the simulated robot
+ *
+ * Can only be called once per process, since tasks left running by the routine can't be stopped
+ *
+ * @param initialize runs first, and isn't timed. Typically calibrates the chassis
+ * @param autonomous the routine to run and time
+ * @param timeLimit the longest the routine can run for, in milliseconds
+ * @return Report what happened during the routine
+ */
+Report run(const std::function<void()>& initialize, const std::function<void()>& autonomous,
+           uint32_t timeLimit = 15000);
+/**
+ * @brief Set where the routine is driving to, so the report can measure overshoot
+ *
+ * Overshoot is how far the robot goes past the target, in the direction it was in when the target was set. Call it
+ * before each motion that should be measured
+ *
+ * @param x x position of the target, in inches
+ * @param y y position of the target, in inches
+ */
+void setTarget(float x, float y);
+/**
+ * @brief Get the actual pose of the simulated robot
+ *
+ * @return lemlib::Pose the pose. x and y in inches, theta in degrees
+ */
+lemlib::Pose getTruePose();
+} // namespace sim
@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <map>
+#include <random>
+#include <thread>
+#include <type_traits>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "sweep.hpp"
+
+namespace sim {
+// reports are sent from the episodes as raw bytes
+static_assert(std::is_trivially_copyable_v<Report>);
+
+/**
+ * @brief Get every set of parameter values to try
+ *
+ * @param parameters the parameters
+ * @param params the sweep parameters
+ * @return std::vector<std::vector<float>> the sets of values
+ */
+static std::vector<std::vector<float>> candidates(const std::vector<Parameter>& parameters, const SweepParams& params) {
+    std::vector<std::vector<float>> out;
+    if (params.mode == SearchMode::RANDOM) {
+        std::mt19937 generator(params.seed);
+        for (int i = 0; i < params.samples; i++) {
+            std::vector<float>& values = out.emplace_back();
+            for (const Parameter& parameter : parameters) {
+                values.push_back(std::uniform_real_distribution<float>(parameter.min, parameter.max)(generator));
+            }
+        }
+        return out;
+    }
+    // count through every combination of steps, with the first parameter changing slowest
+    std::vector<int> step(parameters.size(), 0);
+    while (true) {
+        std::vector<float>& values = out.emplace_back();
+        for (size_t i = 0; i < parameters.size(); i++) {
+            const Parameter& parameter = parameters[i];
+            const int steps = std::max(parameter.steps, 1);
+            values.push_back(steps == 1 ? parameter.min
+                                        : parameter.min + (parameter.max - parameter.min) * step[i] / (steps - 1));
+        }
+        int i = int(parameters.size()) - 1;
+        while (i >= 0 && ++step[i] >= std::max(parameters[i].steps, 1)) step[i--] = 0;
+        if (i < 0) return out;
+    }
+}
+
+/**
+ * @brief Start an episode in a child process
+ *
+ * @param episode the episode
+ * @param values values of the parameters
+ * @param fd where the child process writes its report to
+ * @return pid_t the process id of the child, or -1 if it couldn't be started
+ */
+static pid_t start(const std::function<Report(const std::vector<float>&)>& episode, const std::vector<float>& values,
+                   int& fd) {
+    int pipeFds[2];
+    if (pipe(pipeFds) != 0) return -1;
+    const pid_t pid = fork();
+    if (pid == 0) {
+        close(pipeFds[0]);
+        const Report report = episode(values);
+        // the report is smaller than PIPE_BUF, so it's written all at once
+        const ssize_t written = write(pipeFds[1], &report, sizeof(report));
+        // tasks left running by the routine are still blocked in the scheduler, so don't wait for them
+        _exit(written == sizeof(report) ? 0 : 1);
+    }
+    close(pipeFds[1]);
+    if (pid < 0) {
+        close(pipeFds[0]);
+        return -1;
+    }
+    fd = pipeFds[0];
+    return pid;
+}
+
+std::vector<Trial> sweep(const std::vector<Parameter>& parameters,
+                         const std::function<Report(const std::vector<float>&)>& episode, SweepParams params) {
+    std::vector<Trial> trials;
+    for (std::vector<float>& values : candidates(parameters, params)) trials.push_back({std::move(values)});
+    const int workers = params.workers > 0 ? params.workers : std::max<int>(std::thread::hardware_concurrency(), 1);
+
+    // keep every worker busy until all the episodes are done
+    struct Running {
+            size_t trial;
+            int fd;
+    };
+
+    std::map<pid_t, Running> running;
+    size_t next = 0;
+    while (next < trials.size() || !running.empty()) {
+        while (next < trials.size() && int(running.size()) < workers) {
+            int fd = -1;
+            const pid_t pid = start(episode, trials[next].values, fd);
+            // an episode that couldn't start is left infeasible
+            if (pid > 0) running[pid] = {next, fd};
+            next++;
+        }
+        if (running.empty()) continue;
+        int status = 0;
+        const pid_t pid = wait(&status);
+        if (pid < 0) break;
+        const auto it = running.find(pid);
+        if (it == running.end()) continue;
+        Trial& trial = trials[it->second.trial];
+        Report report;
+        const bool received = read(it->second.fd, &report, sizeof(report)) == sizeof(report);
+        close(it->second.fd);
+        running.erase(it);
+        // an episode that crashed is left infeasible
+        if (!received || !WIFEXITED(status) || WEXITSTATUS(status) != 0) continue;
+        trial.report = report;
+        trial.feasible = !report.timedOut && report.maxOvershoot <= params.maxOvershoot &&
+                         report.tipping <= params.maxTipping;
+    }
+
+    std::stable_sort(trials.begin(), trials.end(), [](const Trial& a, const Trial& b) {
+        if (a.feasible != b.feasible) return a.feasible;
+        return a.report.duration < b.report.duration;
+    });
+    return trials;
+}
+} // namespace sim
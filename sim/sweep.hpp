@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+#include "sim.hpp"
+
+namespace sim {
+/**
+ * @brief A parameter to sweep, like a gain or a lookahead distance
+ */
+struct Parameter {
+        /** name of the parameter, used when printing results */
+        std::string name;
+        /** smallest value to try */
+        float min;
+        /** largest value to try */
+        float max;
+        /** number of evenly spaced values to try in a grid search, including min and max */
+        int steps = 5;
+};
+
+/**
+ * @brief How the values of the parameters are chosen
+ */
+enum class SearchMode {
+    /** every combination of the evenly spaced values of each parameter */
+    GRID,
+    /** values chosen uniformly at random between min and max */
+    RANDOM
+};
+
+/**
+ * @brief Parameters for sweep
+ */
+struct SweepParams {
+        /** how the values of the parameters are chosen */
+        SearchMode mode = SearchMode::GRID;
+        /** number of episodes to run in a random search */
+        int samples = 100;
+        /** seed of the random search. The same seed tries the same values */
+        uint32_t seed = 0;
+        /** number of episodes to run at once. 0 uses every core */
+        int workers = 0;
+        /** most overshoot allowed, in inches */
+        float maxOvershoot = std::numeric_limits<float>::infinity();
+        /** most tipping allowed, as a fraction of the acceleration that would tip the robot over */
+        float maxTipping = 1;
+};
+
+/**
+ * @brief The result of an episode
+ */
+struct Trial {
+        /** values of the parameters, in the order they were passed to sweep */
+        std::vector<float> values;
+        /** report of the episode */
+        Report report;
+        /** whether the episode finished in time without crashing or breaking the constraints */
+        bool feasible = false;
+};
+
+/**
+ * @brief Run an episode for each set of parameter values, and rank them
+ *
+ * Every episode runs in a process of its own, since the simulator can only run once per process, and episodes run in
+ * parallel. The episode has to configure the simulator, set up the chassis with the values it is given, and return
+ * the report of running the routine. Feasible trials are ranked by how long the routine took, followed by the rest.
+ *
+ * Must be called before the simulator has run in this process
+ *
+ * @param parameters the parameters to sweep
+ * @param episode the episode, which is passed the values of the parameters
+ * @param params optional parameters for the sweep
+ * @return std::vector<Trial> the trials, best first
+ */
+std::vector<Trial> sweep(const std::vector<Parameter>& parameters,
+                         const std::function<Report(const std::vector<float>&)>& episode, SweepParams params = {});
+} // namespace sim
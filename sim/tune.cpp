@@ -0,0 +1,83 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "lemlib/api.hpp" // IWYU pragma: keep
+#include "sweep.hpp"
+
+/**
+ * Tunes the robot in src/main.cpp on the simulator. Sweeps the lateral and angular gains and the lead of moveToPose,
+ * and prints the fastest settings that don't overshoot or tip the robot
+ *
+ * Usage: tune [grid|random] [samples]
+ */
+
+/**
+ * @brief Run the routine with a set of gains
+ *
+ * @param values lateral kP, lateral kD, angular kP, angular kD, and lead
+ * @return sim::Report what happened
+ */
+static sim::Report episode(const std::vector<float>& values) {
+    sim::configure({
+        .leftPorts = {8, 10, 14},
+        .rightPorts = {-1, -2, -3},
+        .trackWidth = 12,
+        .wheelDiameter = 3.25,
+        .rpm = 450,
+        .imuPort = 9,
+        .trackingWheels = {{15, 2.75, -5.75, false}, {5, 2.75, -2.5, true}},
+    });
+
+    // the devices are used by tasks that outlive the episode, so they are never freed
+    auto* leftMotors = new pros::MotorGroup({8, 10, 14}, pros::MotorGearset::blue);
+    auto* rightMotors = new pros::MotorGroup({-1, -2, -3}, pros::MotorGearset::blue);
+    auto* imu = new pros::Imu(9);
+    auto* horizontal = new lemlib::TrackingWheel(new pros::Rotation(15), lemlib::Omniwheel::NEW_275, -5.75);
+    auto* vertical = new lemlib::TrackingWheel(new pros::Rotation(5), lemlib::Omniwheel::NEW_275, -2.5);
+    auto* chassis = new lemlib::Chassis(
+        lemlib::Drivetrain(leftMotors, rightMotors, 12, lemlib::Omniwheel::NEW_325, 450, 2),
+        lemlib::ControllerSettings(values[0], 0, values[1], 3, 1, 100, 3, 500, 20),
+        lemlib::ControllerSettings(values[2], 0, values[3], 3, 1, 100, 3, 500, 0),
+        lemlib::OdomSensors(vertical, nullptr, horizontal, nullptr, imu));
+    const float lead = values[4];
+
+    return sim::run([&] { chassis->calibrate(); },
+                    [&] {
+                        chassis->setPose(0, 0, 0);
+                        sim::setTarget(0, 24);
+                        chassis->moveToPoint(0, 24, 2000);
+                        chassis->waitUntilDone();
+                        chassis->turnToHeading(90, 1000);
+                        chassis->waitUntilDone();
+                        sim::setTarget(24, 36);
+                        chassis->moveToPose(24, 36, 0, 3000, {.lead = lead});
+                        chassis->waitUntilDone();
+                        sim::setTarget(0, 0);
+                        chassis->moveToPoint(0, 0, 3000, {.forwards = false});
+                        chassis->waitUntilDone();
+                    });
+}
+
+int main(int argc, char** argv) {
+    sim::SweepParams params {.maxOvershoot = 1, .maxTipping = 0.8};
+    if (argc > 1 && std::strcmp(argv[1], "random") == 0) params.mode = sim::SearchMode::RANDOM;
+    if (argc > 2) params.samples = std::atoi(argv[2]);
+
+    const std::vector<sim::Parameter> parameters = {
+        {"lateral kP", 4, 20, 5}, {"lateral kD", 0, 30, 4}, {"angular kP", 1, 5, 5},
+        {"angular kD", 0, 30, 4}, {"lead", 0.3, 0.7, 3},
+    };
+    const std::vector<sim::Trial> trials = sim::sweep(parameters, episode, params);
+
+    int feasible = 0;
+    for (const sim::Trial& trial : trials) feasible += trial.feasible;
+    std::printf("%d of %zu settings met the constraints\n\n", feasible, trials.size());
+    for (const sim::Parameter& parameter : parameters) std::printf("%12s", parameter.name.c_str());
+    std::printf("%12s%12s%12s\n", "time (s)", "overshoot", "tipping");
+    for (size_t i = 0; i < trials.size() && i < 10; i++) {
+        const sim::Trial& trial = trials[i];
+        for (float value : trial.values) std::printf("%12.3f", value);
+        std::printf("%12.3f%12.3f%12.3f%s\n", trial.report.duration, trial.report.maxOvershoot, trial.report.tipping,
+                    trial.feasible ? "" : "  (infeasible)");
+    }
+}
@@ -0,0 +1,239 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include "scheduler.hpp"
+#include "world.hpp"
+
+namespace sim::world {
+// unit conversions
+constexpr double METERS_PER_INCH = 0.0254;
+constexpr double KG_PER_POUND = 0.4536;
+constexpr double GRAVITY = 9.81;
+// V5 smart motor, 11W. Stall torque and current are for the 100 rpm cartridge at 12 volts
+constexpr double STALL_TORQUE = 2.1;
+constexpr double STALL_CURRENT = 2.5;
+constexpr double RESISTANCE = 12 / STALL_CURRENT;
+constexpr double TORQUE_CONSTANT = STALL_TORQUE / STALL_CURRENT;
+// how hard a motor in the hold brake mode pushes back, in volts per rotation of error
+constexpr double HOLD_GAIN = 200;
+// how long the inertial sensor takes to calibrate, in microseconds
+constexpr uint64_t IMU_CALIBRATION_TIME = 2000000;
+// rolling resistance of the wheels, and resistance of the wheels to scrubbing sideways while turning
+constexpr double ROLLING_RESISTANCE = 0.03;
+constexpr double SCRUB_RESISTANCE = 0.1;
+
+static RobotConfig robot;
+static std::array<Motor, 22> motors;
+static std::array<Rotation, 22> rotations;
+static std::array<Imu, 22> imus;
+
+// actual state of the robot. Heading is clockwise from the y axis, like lemlib
+static double x = 0; // meters
+static double y = 0; // meters
+static double theta = 0; // radians
+static double velocity = 0; // meters per second
+static double angularVelocity = 0; // radians per second, clockwise
+
+// statistics for the report
+static double energy = 0;
+static double voltageTime = 0;
+static double reportTime = 0;
+static double maxSpeed = 0;
+static double maxAccel = 0;
+static double maxOvershoot = 0;
+
+// target overshoot is measured against, and the direction it was approached from
+static bool hasTarget = false;
+static double targetX = 0; // meters
+static double targetY = 0; // meters
+static double approachX = 0;
+static double approachY = 0;
+
+Motor& motor(int8_t port) { return motors.at(std::abs(port)); }
+
+Rotation& rotation(int8_t port) { return rotations.at(std::abs(port)); }
+
+Imu& imu(uint8_t port) { return imus.at(port); }
+
+double imuRotation() { return theta * 180 / M_PI + robot.imuDrift * scheduler::micros() / 1e6; }
+
+float batteryVoltage() { return robot.batteryVoltage; }
+
+/**
+ * @brief Get the free speed of a motor at 12 volts
+ *
+ * @param motor the motor
+ * @return double free speed, in rpm
+ */
+static double cartridgeRpm(const Motor& motor) {
+    switch (motor.gearing) {
+        case 0: return 100;
+        case 2: return 600;
+        default: return 200;
+    }
+}
+
+/**
+ * @brief Step a motor, and calculate the force it applies to the ground
+ *
+ * @param motor the motor to step
+ * @param wheelVelocity linear velocity of its wheel, in meters per second
+ * @param dt time step, in seconds
+ * @return double the force, in newtons
+ */
+static double stepMotor(Motor& motor, double wheelVelocity, double dt) {
+    const double radius = robot.wheelDiameter / 2 * METERS_PER_INCH;
+    const double cartRpm = cartridgeRpm(motor);
+    // the cartridge output turns faster than the wheel by the external gear ratio
+    const double ratio = cartRpm / robot.rpm;
+    const double shaftSpeed = wheelVelocity / radius * ratio; // radians per second
+    const double freeSpeed = cartRpm * 2 * M_PI / 60;
+    const double backEmf = 12 * shaftSpeed / freeSpeed;
+    const double maxVoltage = std::min<double>(robot.batteryVoltage, 12);
+
+    // the voltage the motor applies, or nothing if it is coasting
+    bool coasting = false;
+    double voltage = 0;
+    if (motor.braking || motor.voltage == 0) {
+        if (motor.brakeMode == 0) coasting = true;
+        else if (motor.brakeMode == 2) voltage = -(motor.position - motor.holdPosition) * HOLD_GAIN;
+    } else {
+        voltage = motor.voltage / 1000.0;
+        const double limit = motor.voltageLimit / 1000.0;
+        if (limit != 0) voltage = std::clamp(voltage, -limit, limit);
+    }
+    voltage = std::clamp(voltage, -maxVoltage, maxVoltage);
+
+    // the faster the motor cartridge, the less torque it has per amp
+    double current = coasting ? 0 : (voltage - backEmf) / RESISTANCE;
+    const double currentLimit = motor.currentLimit / 1000.0;
+    current = std::clamp(current, -currentLimit, currentLimit);
+    const double torque = current * TORQUE_CONSTANT * 100 / cartRpm;
+
+    motor.velocity = shaftSpeed * 60 / (2 * M_PI);
+    motor.position += shaftSpeed * dt / (2 * M_PI);
+    motor.current = current;
+    energy += std::max(voltage * current, 0.0) * dt;
+    voltageTime += std::fabs(voltage) * dt;
+    return torque * ratio / radius;
+}
+
+/**
+ * @brief Apply a resistance that can stop the robot, but not push it backwards
+ *
+ * @param drive the force driving the robot
+ * @param speed the speed the resistance acts against
+ * @param resistance the largest the resistance can be
+ * @return double the force after resistance
+ */
+static double resist(double drive, double speed, double resistance) {
+    if (speed != 0) return drive - std::copysign(resistance, speed);
+    // static friction holds the robot still unless the drive force overcomes it
+    if (std::fabs(drive) <= resistance) return 0;
+    return drive - std::copysign(resistance, drive);
+}
+
+void step(float dt) {
+    const double mass = robot.mass * KG_PER_POUND;
+    const double trackWidth = robot.trackWidth * METERS_PER_INCH;
+    const double length = robot.length * METERS_PER_INCH;
+    const double width = robot.width * METERS_PER_INCH;
+    const double inertia = mass * (length * length + width * width) / 12;
+
+    // the left side moves faster when turning clockwise
+    const double leftVelocity = velocity + angularVelocity * trackWidth / 2;
+    const double rightVelocity = velocity - angularVelocity * trackWidth / 2;
+    double leftForce = 0;
+    double rightForce = 0;
+    for (int8_t port : robot.leftPorts) leftForce += stepMotor(motor(port), leftVelocity, dt);
+    for (int8_t port : robot.rightPorts) rightForce += stepMotor(motor(port), rightVelocity, dt);
+    // the wheels slip if they push harder than friction allows
+    const double maxForce = robot.traction * mass * GRAVITY / 2;
+    leftForce = std::clamp(leftForce, -maxForce, maxForce);
+    rightForce = std::clamp(rightForce, -maxForce, maxForce);
+
+    // accelerate the robot
+    const double force = resist(leftForce + rightForce, velocity, ROLLING_RESISTANCE * mass * GRAVITY);
+    const double torque = resist((leftForce - rightForce) * trackWidth / 2, angularVelocity,
+                                 SCRUB_RESISTANCE * mass * GRAVITY * trackWidth / 4);
+    const double prevVelocity = velocity;
+    const double prevAngularVelocity = angularVelocity;
+    velocity += force / mass * dt;
+    angularVelocity += torque / inertia * dt;
+    // friction stops the robot instead of reversing it
+    if (prevVelocity != 0 && std::signbit(prevVelocity) != std::signbit(velocity)) velocity = 0;
+    if (prevAngularVelocity != 0 && std::signbit(prevAngularVelocity) != std::signbit(angularVelocity))
+        angularVelocity = 0;
+
+    // move the robot
+    const double deltaTheta = angularVelocity * dt;
+    const double averageTheta = theta + deltaTheta / 2;
+    x += velocity * dt * sin(averageTheta);
+    y += velocity * dt * cos(averageTheta);
+    theta += deltaTheta;
+
+    // update the tracking wheels
+    for (const TrackingWheelConfig& wheel : robot.trackingWheels) {
+        const double forwards = wheel.vertical ? velocity * dt / METERS_PER_INCH : 0;
+        const double distance = forwards - deltaTheta * wheel.offset;
+        Rotation& sensor = rotation(wheel.port);
+        sensor.position += distance / (wheel.diameter * M_PI) * 36000;
+        sensor.velocity = distance / dt / (wheel.diameter * M_PI) * 36000;
+    }
+
+    // collect statistics
+    reportTime += dt;
+    maxSpeed = std::max(maxSpeed, std::fabs(velocity) / METERS_PER_INCH);
+    maxAccel = std::max(maxAccel, std::fabs(velocity - prevVelocity) / dt / METERS_PER_INCH);
+    if (hasTarget) {
+        const double overshoot = (x - targetX) * approachX + (y - targetY) * approachY;
+        maxOvershoot = std::max(maxOvershoot, overshoot / METERS_PER_INCH);
+    }
+}
+
+void configure(const RobotConfig& config, lemlib::Pose start) {
+    robot = config;
+    x = start.x * METERS_PER_INCH;
+    y = start.y * METERS_PER_INCH;
+    theta = start.theta * M_PI / 180;
+    velocity = 0;
+    angularVelocity = 0;
+    // the inertial sensor reads 0 until it is reset
+    if (robot.imuPort != 0) imu(robot.imuPort).offset = imuRotation();
+}
+
+lemlib::Pose pose() { return lemlib::Pose(x / METERS_PER_INCH, y / METERS_PER_INCH, theta * 180 / M_PI); }
+
+void setTarget(float x, float y) {
+    targetX = x * METERS_PER_INCH;
+    targetY = y * METERS_PER_INCH;
+    const double distance = std::hypot(targetX - world::x, targetY - world::y);
+    // a robot that is already at the target can't overshoot it in any particular direction
+    hasTarget = distance > 0;
+    if (!hasTarget) return;
+    approachX = (targetX - world::x) / distance;
+    approachY = (targetY - world::y) / distance;
+}
+
+void startReport() {
+    energy = 0;
+    voltageTime = 0;
+    reportTime = 0;
+    maxSpeed = 0;
+    maxAccel = 0;
+    maxOvershoot = 0;
+}
+
+void finishReport(Report& report) {
+    const size_t motorCount = robot.leftPorts.size() + robot.rightPorts.size();
+    report.energy = energy;
+    if (reportTime > 0 && motorCount > 0) report.effort = voltageTime / reportTime / motorCount / 12;
+    report.maxSpeed = maxSpeed;
+    report.maxAccel = maxAccel;
+    // the robot tips when the acceleration torque about a wheel is more than gravity can hold down
+    const double gravity = GRAVITY / METERS_PER_INCH;
+    if (robot.length > 0) report.tipping = maxAccel * robot.cgHeight / (gravity * robot.length / 2);
+    report.maxOvershoot = maxOvershoot;
+    report.finalPose = pose();
+}
+} // namespace sim::world
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstdint>
+#include "sim.hpp"
+
+/**
+ * @brief State of the simulated devices and robot
+ *
+ * The simulated PROS layer reads and writes devices through here, and the scheduler steps the physics
+ */
+namespace sim::world {
+/**
+ * @brief State of a simulated motor
+ *
+ * Positions and velocities are of the output shaft of the cartridge, like the ones reported by a real motor
+ */
+struct Motor {
+        /** commanded voltage, in millivolts */
+        int32_t voltage = 0;
+        /** whether the motor was told to brake, rather than given a voltage */
+        bool braking = false;
+        /** brake mode, as a pros::MotorBrake */
+        int brakeMode = 0;
+        /** gearset, as a pros::MotorGears */
+        int gearing = 1;
+        /** encoder units, as a pros::MotorUnits */
+        int units = 0;
+        /** position, in rotations */
+        double position = 0;
+        /** position the position is measured from, in rotations */
+        double zero = 0;
+        /** position held in the hold brake mode, in rotations */
+        double holdPosition = 0;
+        /** velocity, in rpm */
+        double velocity = 0;
+        /** current draw, in amps */
+        double current = 0;
+        /** current limit, in milliamps */
+        int32_t currentLimit = 2500;
+        /** voltage limit, in millivolts. 0 for no limit */
+        int32_t voltageLimit = 0;
+};
+
+/**
+ * @brief State of a simulated rotation sensor
+ */
+struct Rotation {
+        /** position, in centidegrees */
+        double position = 0;
+        /** velocity, in centidegrees per second */
+        double velocity = 0;
+};
+
+/**
+ * @brief State of a simulated inertial sensor
+ */
+struct Imu {
+        /** rotation when the sensor was last reset, in degrees */
+        double offset = 0;
+        /** time calibration finishes, in microseconds */
+        uint64_t calibrationEnd = 0;
+};
+
+/**
+ * @brief Get a motor by port. Reversed ports give the same motor
+ *
+ * @param port the port of the motor
+ * @return Motor& the motor
+ */
+Motor& motor(int8_t port);
+/**
+ * @brief Get a rotation sensor by port
+ *
+ * @param port the port of the sensor
+ * @return Rotation& the sensor
+ */
+Rotation& rotation(int8_t port);
+/**
+ * @brief Get an inertial sensor by port
+ *
+ * @param port the port of the sensor
+ * @return Imu& the sensor
+ */
+Imu& imu(uint8_t port);
+/**
+ * @brief Get the rotation the inertial sensor would measure, before its offset is applied
+ *
+ * @return double rotation, in degrees, clockwise positive
+ */
+double imuRotation();
+/**
+ * @brief Get the battery voltage
+ *
+ * @return float voltage, in volts
+ */
+float batteryVoltage();
+/**
+ * @brief Step the physics of the robot
+ *
+ * @param dt time step, in seconds
+ */
+void step(float dt);
+/**
+ * @brief Set up the robot
+ *
+ * @param config the robot
+ * @param start where the robot starts. x and y in inches, theta in degrees
+ */
+void configure(const RobotConfig& config, lemlib::Pose start);
+/**
+ * @brief Get the actual pose of the robot
+ *
+ * @return lemlib::Pose the pose. x and y in inches, theta in degrees
+ */
+lemlib::Pose pose();
+/**
+ * @brief Set the target overshoot is measured against
+ *
+ * @param x x position of the target, in inches
+ * @param y y position of the target, in inches
+ */
+void setTarget(float x, float y);
+/**
+ * @brief Clear the statistics collected for the report, and start collecting them
+ */
+void startReport();
+/**
+ * @brief Fill in the statistics collected since startReport
+ *
+ * @param report the report to fill in
+ */
+void finishReport(Report& report);
+} // namespace sim::world
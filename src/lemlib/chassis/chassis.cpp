@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <math.h>
 #include "pros/imu.hpp"
 #include "pros/motors.h"
@@ -9,6 +10,9 @@
 #include "lemlib/chassis/trackingWheel.hpp"
 #include "pros/rtos.hpp"
 
+// how long the state handed off by a blending motion stays valid, in milliseconds
+constexpr uint32_t HANDOFF_TIMEOUT = 100;
+
 lemlib::OdomSensors::OdomSensors(TrackingWheel* vertical1, TrackingWheel* vertical2, TrackingWheel* horizontal1,
                                  TrackingWheel* horizontal2, pros::Imu* imu)
     : vertical1(vertical1),
@@ -17,6 +21,11 @@ lemlib::OdomSensors::OdomSensors(TrackingWheel* vertical1, TrackingWheel* vertic
       horizontal2(horizontal2),
       imu(imu) {}
 
+float lemlib::ControllerSettings::feedforward(float velocity, float acceleration) const {
+    const float staticOut = velocity == 0 ? 0 : kS * sgn(velocity);
+    return staticOut + kV * velocity + kA * acceleration;
+}
+
 lemlib::Drivetrain::Drivetrain(pros::MotorGroup* leftMotors, pros::MotorGroup* rightMotors, float trackWidth,
                                float wheelDiameter, float rpm, float horizontalDrift)
     : leftMotors(leftMotors),
@@ -28,18 +37,21 @@ lemlib::Drivetrain::Drivetrain(pros::MotorGroup* leftMotors, pros::MotorGroup* r
 
 lemlib::Chassis::Chassis(Drivetrain drivetrain, ControllerSettings linearSettings, ControllerSettings angularSettings,
                          OdomSensors sensors, DriveCurve* throttleCurve, DriveCurve* steerCurve)
-    : drivetrain(drivetrain),
+    : lateralPID(linearSettings.kP, linearSettings.kI, linearSettings.kD, linearSettings.windupRange, true),
+      angularPID(angularSettings.kP, angularSettings.kI, angularSettings.kD, angularSettings.windupRange, true),
       lateralSettings(linearSettings),
       angularSettings(angularSettings),
+      drivetrain(drivetrain),
+      driveOutput(drivetrain.leftMotors, drivetrain.rightMotors),
       sensors(sensors),
       throttleCurve(throttleCurve),
       steerCurve(steerCurve),
-      lateralPID(linearSettings.kP, linearSettings.kI, linearSettings.kD, linearSettings.windupRange, true),
-      angularPID(angularSettings.kP, angularSettings.kI, angularSettings.kD, angularSettings.windupRange, true),
       lateralLargeExit(lateralSettings.largeError, lateralSettings.largeErrorTimeout),
-      lateralSmallExit(lateralSettings.smallError, lateralSettings.smallErrorTimeout),
+      lateralSmallExit(lateralSettings.smallError, lateralSettings.smallErrorTimeout, lateralSettings.settleRate,
+                       lateralSettings.settleVelocity, lateralSettings.settleTime),
       angularLargeExit(angularSettings.largeError, angularSettings.largeErrorTimeout),
-      angularSmallExit(angularSettings.smallError, angularSettings.smallErrorTimeout) {}
+      angularSmallExit(angularSettings.smallError, angularSettings.smallErrorTimeout, angularSettings.settleRate,
+                       angularSettings.settleVelocity, angularSettings.settleTime) {}
 
 /**
  * @brief calibrate the IMU given a sensors struct
@@ -123,6 +135,14 @@ void lemlib::Chassis::requestMotionStart() {
     // wait until this motion is at front of "queue"
     this->mutex.take(TIMEOUT_MAX);
 
+    // the previous motion left the drivetrain running for this motion to take over. Stop it if this motion was
+    // cancelled while it was queued
+    if (!this->motionRunning && handoff) {
+        handoff = std::nullopt;
+        driveOutput.move(0, 0);
+        driveOutput.flush();
+    }
+
     // this->motionRunning should be true
     // and this->motionQueued should be false
     // indicating this motion is running
@@ -137,6 +157,51 @@ void lemlib::Chassis::endMotion() {
     this->mutex.give();
 }
 
+void lemlib::Chassis::stopOrHandoff(bool blend, float lateralOut, float angularOut) {
+    // leave the drivetrain running if another motion is waiting to take over
+    if (blend && this->motionQueued) {
+        handoff = MotionHandoff {lateralOut, angularOut, clock->millis()};
+        return;
+    }
+    driveOutput.move(0, 0);
+    driveOutput.flush();
+}
+
+std::optional<lemlib::Chassis::MotionHandoff> lemlib::Chassis::takeHandoff() {
+    const std::optional<MotionHandoff> taken = handoff;
+    handoff = std::nullopt;
+    // the robot can't be assumed to still be moving if the handoff is too old
+    if (!taken || clock->millis() - taken->time > HANDOFF_TIMEOUT) return std::nullopt;
+    return taken;
+}
+
+float lemlib::Chassis::getBlendSpeed(Pose target, float heading, float distance, float minSpeed, float maxSpeed,
+                                     bool forwards) {
+    if (!queuedTarget) return maxSpeed;
+    // the sharper the corner, the slower the robot has to go. A full reversal slows it down to the minimum speed
+    // the corner is between where the front of the robot faces now and where it has to face for the queued motion, so
+    // switching between driving forwards and backwards turns the robot around
+    const float facing = forwards ? heading : heading + M_PI;
+    const float nextFacing = queuedForwards ? target.angle(*queuedTarget) : target.angle(*queuedTarget) + M_PI;
+    const float turn = angleError(nextFacing, facing);
+    const float cornerSpeed = std::fmax(fabs(minSpeed), maxSpeed * (1 + cos(turn)) / 2);
+    // decelerate towards the corner speed at the rate the slew allows
+    // if there is no slew, only slow down once the robot is close to the target
+    const float maxVelocity = drivetrain.rpm * drivetrain.wheelDiameter * M_PI / 60;
+    if (lateralSettings.slew == 0 || maxVelocity == 0) return distance < 7.5 ? cornerSpeed : maxSpeed;
+    // v^2 = vc^2 + 2ad, converted from inches per second to power
+    const float decel = lateralSettings.slew * 100;
+    const float allowed = sqrt(cornerSpeed * cornerSpeed + 2 * decel * distance * 127 / maxVelocity);
+    return std::fmin(allowed, maxSpeed);
+}
+
+void lemlib::Chassis::scheduleGains(PID& pid, const ControllerSettings& settings, float error, float speed,
+                                    float motionSize) {
+    if (!settings.gainSchedule || settings.gainSchedule->empty()) return;
+    const ScheduledGains gains = settings.gainSchedule->get(error, speed, motionSize);
+    pid.setGains(gains.kP, gains.kI, gains.kD);
+}
+
 void lemlib::Chassis::cancelMotion() {
     this->motionRunning = false;
     pros::delay(10); // give time for motion to stop
@@ -159,3 +224,53 @@ void lemlib::Chassis::setBrakeMode(pros::motor_brake_mode_e mode) {
     drivetrain.leftMotors->set_brake_mode_all(mode);
     drivetrain.rightMotors->set_brake_mode_all(mode);
 }
+
+void lemlib::Chassis::setNominalVoltage(float nominalVoltage) { driveOutput.setNominalVoltage(nominalVoltage); }
+
+float lemlib::Chassis::getVoltageCompensation() { return driveOutput.getCompensation(); }
+
+void lemlib::Chassis::setOutputEpsilon(int32_t epsilon) { driveOutput.setEpsilon(epsilon); }
+
+uint32_t lemlib::Chassis::getWritesSaved() const { return driveOutput.getWritesSaved(); }
+
+void lemlib::Chassis::setClock(Clock* clock) {
+    this->clock = clock;
+    lateralLargeExit.setClock(clock);
+    lateralSmallExit.setClock(clock);
+    angularLargeExit.setClock(clock);
+    angularSmallExit.setClock(clock);
+}
+
+void lemlib::Chassis::setVelocityController(VelocityControllerSettings settings) { velocitySettings = settings; }
+
+float lemlib::Chassis::getWheelVelocity(DriveSide side) {
+    if (velocitySettings.useOdom) {
+        // the wheels on the outside of a turn move faster than the center of the robot
+        // theta increases clockwise, so the left wheels are on the outside of a positive turn
+        const Pose speed = getLocalSpeed(true);
+        const float turnSpeed = speed.theta * drivetrain.trackWidth / 2;
+        return side == DriveSide::LEFT ? speed.y + turnSpeed : speed.y - turnSpeed;
+    }
+    // average the velocity of each motor on the side, converted to wheel speed in inches per second
+    pros::MotorGroup* motors = side == DriveSide::LEFT ? drivetrain.leftMotors : drivetrain.rightMotors;
+    WheelMotors& wheelMotors = side == DriveSide::LEFT ? leftWheelMotors : rightWheelMotors;
+    // motors can be added to a motor group after the drivetrain is created
+    const size_t count = std::min<size_t>(motors->size(), wheelMotors.scale.size());
+    if (count != wheelMotors.count) {
+        for (size_t i = 0; i < count; i++) {
+            float in;
+            switch (motors->get_gearing(i)) {
+                case pros::MotorGears::red: in = 100; break;
+                case pros::MotorGears::green: in = 200; break;
+                case pros::MotorGears::blue: in = 600; break;
+                default: in = 200; break;
+            }
+            wheelMotors.scale[i] = drivetrain.rpm / in * drivetrain.wheelDiameter * M_PI / 60;
+        }
+        wheelMotors.count = count;
+    }
+    if (count == 0) return 0;
+    float sum = 0;
+    for (size_t i = 0; i < count; i++) sum += motors->get_actual_velocity(i) * wheelMotors.scale[i];
+    return sum / count;
+}
@@ -0,0 +1,110 @@
+#include <algorithm>
+#include <cmath>
+#include "pros/misc.hpp"
+#include "pros/motors.h"
+#include "pros/rtos.hpp"
+#include "lemlib/chassis/driveOutput.hpp"
+#include "lemlib/logger/binaryTelemetry.hpp"
+#include "lemlib/util.hpp"
+
+// how often the battery voltage is sampled, in milliseconds
+constexpr uint32_t BATTERY_SAMPLE_PERIOD = 250;
+// how often a cached command is resent even if it hasn't changed, in milliseconds
+constexpr uint32_t COMMAND_REFRESH_PERIOD = 100;
+
+namespace lemlib {
+DriveOutput::DriveOutput(pros::MotorGroup* leftMotors, pros::MotorGroup* rightMotors)
+    : left({leftMotors}),
+      right({rightMotors}) {}
+
+void DriveOutput::setNominalVoltage(float nominalVoltage) { this->nominalVoltage = std::fabs(nominalVoltage); }
+
+void DriveOutput::updateBattery() {
+    const uint32_t now = pros::millis();
+    uint32_t last = lastSampleTime;
+    if (sampled && now - last < BATTERY_SAMPLE_PERIOD) return;
+    // the control loop and other tasks, like the screen, can both get here. Only the one that claims the sample takes
+    // it, and the others keep using the last sample
+    if (!lastSampleTime.compare_exchange_strong(last, now)) return;
+    const int32_t millivolts = pros::battery::get_voltage();
+    // keep the last sample if the battery couldn't be read
+    if (millivolts == PROS_ERR || millivolts <= 0) return;
+    // smooth out the dips caused by current spikes
+    if (!sampled) batteryVoltage = millivolts / 1000.0;
+    else batteryVoltage = ema(millivolts / 1000.0, batteryVoltage.load(), 0.5);
+    sampled = true;
+}
+
+float DriveOutput::getBatteryVoltage() {
+    updateBattery();
+    return batteryVoltage;
+}
+
+float DriveOutput::getCompensation() {
+    if (nominalVoltage == 0) return 1;
+    updateBattery();
+    return nominalVoltage / batteryVoltage;
+}
+
+int32_t DriveOutput::toMillivolts(float power) {
+    // full power is 12000 mV. The motors can't apply more than the battery has, so clamp it
+    return std::clamp(power / 127 * 12000 * getCompensation(), -12000.0f, 12000.0f);
+}
+
+void DriveOutput::setEpsilon(int32_t epsilon) { this->epsilon = std::abs(epsilon); }
+
+bool DriveOutput::needsWrite(const CachedCommand& cached, const MotorCommand& command, uint32_t now) const {
+    if (!cached.valid || now - cached.time >= COMMAND_REFRESH_PERIOD) return true;
+    if (cached.command.brake != command.brake) return true;
+    if (command.brake) return false;
+    // always stop the motors exactly, even if they were commanded a voltage within the epsilon of 0
+    if (command.millivolts == 0) return cached.command.millivolts != 0;
+    return std::abs(command.millivolts - cached.command.millivolts) > epsilon;
+}
+
+void DriveOutput::flushSide(Side& side, uint32_t now) {
+    if (!side.staged) return;
+    const MotorCommand command = *side.staged;
+    side.staged.reset();
+    // motors can be added to a motor group after the drivetrain is created
+    if (side.ports.size() != size_t(side.motors->size())) {
+        side.ports = side.motors->get_port_all();
+        side.cache.assign(side.ports.size(), {});
+    }
+    for (size_t i = 0; i < side.ports.size(); i++) {
+        CachedCommand& cached = side.cache[i];
+        if (!needsWrite(cached, command, now)) {
+            writesSaved++;
+            continue;
+        }
+        if (command.brake) pros::c::motor_brake(side.ports[i]);
+        else pros::c::motor_move_voltage(side.ports[i], command.millivolts);
+        cached = {command, now, true};
+        writesSent++;
+    }
+}
+
+void DriveOutput::flush() {
+    const uint32_t now = pros::millis();
+    flushSide(left, now);
+    flushSide(right, now);
+}
+
+uint32_t DriveOutput::getWritesSent() const { return writesSent; }
+
+uint32_t DriveOutput::getWritesSaved() const { return writesSaved; }
+
+void DriveOutput::move(float leftPower, float rightPower) {
+    binaryTelemetry().send(TelemetryChannel::MOTOR_POWER, {leftPower, rightPower});
+    moveLeft(leftPower);
+    moveRight(rightPower);
+}
+
+void DriveOutput::moveLeft(float power) { left.staged = MotorCommand {false, toMillivolts(power)}; }
+
+void DriveOutput::moveRight(float power) { right.staged = MotorCommand {false, toMillivolts(power)}; }
+
+void DriveOutput::brakeLeft() { left.staged = MotorCommand {true, 0}; }
+
+void DriveOutput::brakeRight() { right.staged = MotorCommand {true, 0}; }
+} // namespace lemlib
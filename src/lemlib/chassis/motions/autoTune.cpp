@@ -0,0 +1,120 @@
+#include <cmath>
+#include <vector>
+#include "lemlib/chassis/chassis.hpp"
+#include "lemlib/logger/logger.hpp"
+#include "lemlib/timer.hpp"
+#include "lemlib/util.hpp"
+
+// period of the control loop, in seconds. The PID gains are per iteration, so the suggested gains are scaled by it
+constexpr float LOOP_PERIOD = 0.01;
+
+/**
+ * @brief Log PID gains calculated from the ultimate gain and period
+ *
+ * @param name name of the tuning rule
+ * @param settings the current settings of the controller, used for everything other than the gains
+ * @param kP proportional gain
+ * @param ti integral time, in seconds
+ * @param td derivative time, in seconds
+ */
+static void logSuggestion(const char* name, const lemlib::ControllerSettings& settings, float kP, float ti, float td) {
+    // convert the integral and derivative times to gains for a PID that is updated every LOOP_PERIOD
+    const float kI = kP * LOOP_PERIOD / ti;
+    const float kD = kP * td / LOOP_PERIOD;
+    lemlib::infoSink()->info("{}: lemlib::ControllerSettings({:.3f}, {:.4f}, {:.3f}, {}, {}, {}, {}, {}, {})", name, kP,
+                             kI, kD, settings.windupRange, settings.smallError, settings.smallErrorTimeout,
+                             settings.largeError, settings.largeErrorTimeout, settings.slew);
+}
+
+void lemlib::Chassis::autoTune(TuneTarget target, AutoTuneParams params, bool async) {
+    params.relayPower = std::fabs(params.relayPower);
+    params.hysteresis = std::fabs(params.hysteresis);
+    this->requestMotionStart();
+    // were all motions cancelled?
+    if (!this->motionRunning) return;
+    // if the function is async, run it in a new task
+    if (async) {
+        pros::Task task([&]() { autoTune(target, params, false); });
+        this->endMotion();
+        pros::delay(10); // delay to give the task time to start
+        return;
+    }
+
+    // only lateral motions pick up from a blend, so the handoff is dropped instead of left for a later motion
+    takeHandoff();
+
+    const bool angular = target == TuneTarget::ANGULAR;
+    const Pose start = getPose(true, true);
+    Pose lastPose = start;
+    distTraveled = 0;
+    Timer timer(params.timeout, clock);
+    float relay = 1;
+    // time of each switch from negative to positive relay power, which happens once per oscillation
+    std::vector<uint32_t> risingSwitches;
+    // peak to peak amplitude of each oscillation
+    std::vector<float> amplitudes;
+    float peakHigh = -INFINITY;
+    float peakLow = INFINITY;
+
+    while (!timer.isDone() && this->motionRunning && int(risingSwitches.size()) <= params.cycles + 1) {
+        const Pose pose = getPose(true, true);
+        distTraveled += pose.distance(lastPose);
+        lastPose = pose;
+
+        // error is target minus position, with the same sign convention as the motions use
+        // the angular error is negated since positive power turns the robot clockwise
+        const float error = angular ? -radToDeg(angleError(start.theta, pose.theta))
+                                    : (start.x - pose.x) * cos(start.theta) + (start.y - pose.y) * sin(start.theta);
+        peakHigh = std::fmax(peakHigh, error);
+        peakLow = std::fmin(peakLow, error);
+
+        // switch the relay once the error has crossed the hysteresis band
+        if (relay < 0 && error > params.hysteresis) {
+            relay = 1;
+            // a full oscillation has happened since the last rising switch
+            if (!risingSwitches.empty()) amplitudes.push_back(peakHigh - peakLow);
+            risingSwitches.push_back(clock->millis());
+            peakHigh = error;
+            peakLow = error;
+        } else if (relay > 0 && error < -params.hysteresis) {
+            relay = -1;
+        }
+
+        const float power = relay * params.relayPower;
+        if (angular) driveOutput.move(power, -power);
+        else driveOutput.move(power, power);
+        driveOutput.flush();
+
+        clock->delay(10);
+    }
+
+    // stop the drivetrain
+    driveOutput.move(0, 0);
+    driveOutput.flush();
+
+    // the first oscillation is still affected by the robot starting from rest, so it is skipped
+    if (!this->motionRunning) {
+        infoSink()->warn("Auto tune cancelled, gains were not calculated");
+    } else if (int(amplitudes.size()) < params.cycles || amplitudes.size() < 2) {
+        infoSink()->error("Auto tune failed, only measured {} oscillations. Try a higher relay power or timeout",
+                          amplitudes.size());
+    } else {
+        const int measured = amplitudes.size() - 1;
+        float amplitude = 0;
+        for (int i = 1; i <= measured; i++) amplitude += amplitudes[i] / 2 / measured;
+        const float period = float(risingSwitches.back() - risingSwitches[1]) / 1000 / (risingSwitches.size() - 2);
+        // describing function of a relay with hysteresis
+        const float hysteresis = params.hysteresis;
+        const float effectiveAmplitude = std::sqrt(std::fmax(amplitude * amplitude - hysteresis * hysteresis, 1e-6f));
+        const float ultimateGain = 4 * params.relayPower / (M_PI * effectiveAmplitude);
+        infoSink()->info("Auto tune done. Ultimate gain: {:.3f}, ultimate period: {:.3f} s, amplitude: {:.2f}",
+                         ultimateGain, period, amplitude);
+        const ControllerSettings& settings = angular ? angularSettings : lateralSettings;
+        logSuggestion("Ziegler-Nichols", settings, 0.6 * ultimateGain, period / 2, period / 8);
+        logSuggestion("No overshoot", settings, 0.2 * ultimateGain, period / 2, period / 3);
+    }
+
+    // set distTraveled to -1 to indicate that the function has finished
+    distTraveled = -1;
+    this->endMotion();
+}
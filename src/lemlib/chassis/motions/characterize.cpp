@@ -0,0 +1,129 @@
+#include <array>
+#include <cmath>
+#include "lemlib/chassis/chassis.hpp"
+#include "lemlib/chassis/odom.hpp"
+#include "lemlib/logger/logger.hpp"
+#include "lemlib/timer.hpp"
+#include "lemlib/util.hpp"
+
+/**
+ * @brief Least squares fit of power = kS * sgn(velocity) + kV * velocity + kA * acceleration
+ *
+ * Only the sums needed for the normal equations are stored, so memory use doesn't grow with the number of samples
+ */
+class FeedforwardFit {
+    public:
+        /**
+         * @brief add a sample to the fit
+         *
+         * @param power the power that was applied
+         * @param velocity the measured velocity
+         * @param acceleration the measured acceleration
+         */
+        void addSample(float power, float velocity, float acceleration) {
+            const std::array<double, 3> x = {double(lemlib::sgn(velocity)), velocity, acceleration};
+            for (int i = 0; i < 3; i++) {
+                for (int j = 0; j < 3; j++) xtx[i][j] += x[i] * x[j];
+                xty[i] += x[i] * power;
+            }
+            samples++;
+        }
+
+        /**
+         * @brief solve the normal equations with Cramer's rule
+         *
+         * @return std::array<float, 3> kS, kV, and kA. All 0 if there is not enough data to fit
+         */
+        std::array<float, 3> solve() const {
+            const double det = determinant(xtx);
+            if (std::fabs(det) < 1e-9) return {0, 0, 0};
+            std::array<float, 3> gains;
+            for (int i = 0; i < 3; i++) {
+                std::array<std::array<double, 3>, 3> replaced = xtx;
+                for (int j = 0; j < 3; j++) replaced[j][i] = xty[j];
+                gains[i] = determinant(replaced) / det;
+            }
+            return gains;
+        }
+
+        int getSamples() const { return samples; }
+    private:
+        static double determinant(const std::array<std::array<double, 3>, 3>& m) {
+            return m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) -
+                   m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0]) +
+                   m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+        }
+
+        std::array<std::array<double, 3>, 3> xtx {};
+        std::array<double, 3> xty {};
+        int samples = 0;
+};
+
+void lemlib::Chassis::characterize(float maxDistance, CharacterizeParams params, bool async) {
+    this->requestMotionStart();
+    // were all motions cancelled?
+    if (!this->motionRunning) return;
+    // if the function is async, run it in a new task
+    if (async) {
+        pros::Task task([&]() { characterize(maxDistance, params, false); });
+        this->endMotion();
+        pros::delay(10); // delay to give the task time to start
+        return;
+    }
+
+    // only lateral motions pick up from a blend, so the handoff is dropped instead of left for a later motion
+    takeHandoff();
+
+    FeedforwardFit fit;
+    distTraveled = 0;
+
+    // runs a single test, driving forwards for the quasistatic test and backwards for the dynamic test
+    auto runTest = [&](bool quasistatic) {
+        const float direction = quasistatic ? 1 : -1;
+        const Pose start = getPose();
+        Timer timer(params.testTimeout, clock);
+        float power = 0;
+        float prevPower = 0;
+        float prevVelocity = getLocalSpeed(true).y;
+        float acceleration = 0;
+
+        while (!timer.isDone() && this->motionRunning && getPose().distance(start) < maxDistance) {
+            // measure how the robot responded to the power applied last iteration
+            const float velocity = getLocalSpeed(true).y;
+            acceleration = ema((velocity - prevVelocity) / 0.01, acceleration, 0.5);
+            prevVelocity = velocity;
+            // the model doesn't hold while the robot is held still by static friction
+            if (std::fabs(velocity) > 0.5) fit.addSample(prevPower, velocity, acceleration);
+
+            // calculate the power for this iteration
+            if (quasistatic) power = std::fmin(power + params.rampRate * 0.01, 127);
+            else power = params.stepPower;
+            prevPower = power * direction;
+
+            driveOutput.move(prevPower, prevPower);
+            driveOutput.flush();
+            clock->delay(10);
+        }
+
+        // stop the drivetrain and give the robot time to come to rest
+        driveOutput.move(0, 0);
+        driveOutput.flush();
+        clock->delay(1000);
+        distTraveled += getPose().distance(start);
+    };
+
+    runTest(true);
+    if (this->motionRunning) runTest(false);
+
+    // fit the gains and report them
+    const std::array<float, 3> gains = fit.solve();
+    if (!this->motionRunning) infoSink()->warn("Characterization cancelled, gains were not calculated");
+    else if (gains[1] == 0) infoSink()->error("Characterization failed, not enough samples ({})", fit.getSamples());
+    else
+        infoSink()->info("Characterization done with {} samples. kS: {:.3f}, kV: {:.4f}, kA: {:.4f}", fit.getSamples(),
+                         gains[0], gains[1], gains[2]);
+
+    // set distTraveled to -1 to indicate that the function has finished
+    distTraveled = -1;
+    this->endMotion();
+}
@@ -1,12 +1,20 @@
 #include <cmath>
 #include "lemlib/chassis/chassis.hpp"
+#include "lemlib/chassis/odom.hpp"
 #include "lemlib/logger/logger.hpp"
+#include "lemlib/motionProfile.hpp"
+#include "lemlib/profiler.hpp"
 #include "lemlib/timer.hpp"
 #include "lemlib/util.hpp"
 #include "pros/misc.hpp"
 
 void lemlib::Chassis::moveToPoint(float x, float y, int timeout, MoveToPointParams params, bool async) {
     params.earlyExitRange = fabs(params.earlyExitRange);
+    // let the running motion know where the robot is going next, so it can blend into this motion
+    if (this->isInMotion()) {
+        queuedTarget = Pose(x, y);
+        queuedForwards = params.forwards;
+    }
     this->requestMotionStart();
     // were all motions cancelled?
     if (!this->motionRunning) return;
@@ -18,29 +26,57 @@ void lemlib::Chassis::moveToPoint(float x, float y, int timeout, MoveToPointPara
         return;
     }
 
+    // if the previous motion blended into this one, pick up where it left off instead of starting from rest
+    queuedTarget = std::nullopt;
+    const std::optional<MotionHandoff> handoff = takeHandoff();
+
     // reset PIDs and exit conditions
+    // the output carries over from a handoff, but the errors of the PIDs belonged to the previous target. They are
+    // seeded with the first errors towards this target instead, so the derivative doesn't kick
     lateralPID.reset();
+    angularPID.reset();
+    bool seedPIDs = handoff.has_value();
     lateralLargeExit.reset();
     lateralSmallExit.reset();
-    angularPID.reset();
 
     // initialize vars used between iterations
     Pose lastPose = getPose();
     distTraveled = 0;
-    Timer timer(timeout);
+    Timer timer(timeout, clock);
+    uint32_t prevTime = clock->millis();
     bool close = false;
-    float prevLateralOut = 0; // previous lateral power
-    float prevAngularOut = 0; // previous angular power
+    bool chained = false;
+    float prevLateralOut = handoff ? handoff->lateralOut : 0; // previous lateral power
+    float prevAngularOut = handoff ? handoff->angularOut : 0; // previous angular power
     const int compState = pros::competition::get_status();
     std::optional<bool> prevSide = std::nullopt;
+    std::optional<float> turnSize = std::nullopt; // initial angular error, for gain scheduling
 
     // calculate target pose in standard form
     Pose target(x, y);
     target.theta = lastPose.angle(target);
 
+    // plan the velocity profile, if one was requested
+    const Pose start = lastPose;
+    const float profileDist = start.distance(target);
+    // theoretical top speed of the drivetrain, in inches per second
+    const float maxVelocity = drivetrain.rpm * drivetrain.wheelDiameter * M_PI / 60;
+    std::optional<MotionProfile> profile = std::nullopt;
+    if (params.profiled) {
+        // if no acceleration was given, convert the lateral slew from power per 10ms to inches per second squared
+        const float maxAccel =
+            params.maxAccel != 0 ? fabs(params.maxAccel) : lateralSettings.slew / 127 * maxVelocity * 100;
+        if (maxAccel == 0 || maxVelocity == 0) {
+            infoSink()->warn("moveToPoint has no acceleration limit to plan a profile with, running unprofiled");
+        } else {
+            profile = MotionProfile(profileDist, params.maxSpeed / 127 * maxVelocity, maxAccel, fabs(params.maxJerk));
+        }
+    }
+
     // main loop
     while (!timer.isDone() && ((!lateralSmallExit.getExit() && !lateralLargeExit.getExit()) || !close) &&
            this->motionRunning) {
+        LEMLIB_PROFILE(ProfileSection::MOVE_TO_POINT);
         // update position
         const Pose pose = getPose(true, true);
 
@@ -52,7 +88,10 @@ void lemlib::Chassis::moveToPoint(float x, float y, int timeout, MoveToPointPara
         const float distTarget = pose.distance(target);
 
         // check if the robot is close enough to the target to start settling
-        if (distTarget < 7.5 && close == false) {
+        // when following a profile, settling starts once the profile is complete
+        const float elapsed = timer.getTimePassed() / 1000.0;
+        if (profile) close = elapsed >= profile->getDuration();
+        else if (distTarget < 7.5 && close == false) {
             close = true;
             params.maxSpeed = fmax(fabs(prevLateralOut), 60);
         }
@@ -63,7 +102,10 @@ void lemlib::Chassis::moveToPoint(float x, float y, int timeout, MoveToPointPara
         if (prevSide == std::nullopt) prevSide = side;
         const bool sameSide = side == prevSide;
         // exit if close
-        if (!sameSide && params.minSpeed != 0) break;
+        if (!sameSide && params.minSpeed != 0) {
+            chained = true;
+            break;
+        }
         prevSide = side;
 
         // calculate error
@@ -72,12 +114,44 @@ void lemlib::Chassis::moveToPoint(float x, float y, int timeout, MoveToPointPara
         float lateralError = pose.distance(target) * cos(angleError(pose.theta, pose.angle(target)));
 
         // update exit conditions
-        lateralSmallExit.update(lateralError);
-        lateralLargeExit.update(lateralError);
+        const uint32_t now = clock->millis();
+        const float dt = now - prevTime;
+        prevTime = now;
+        const Pose speed = getLocalSpeed(true);
+        lateralSmallExit.update(lateralError, now, speed.y);
+        lateralLargeExit.update(lateralError, now);
+        binaryTelemetry().send(TelemetryChannel::CONTROLLER_ERROR, {lateralError, radToDeg(angularError)});
+
+        // look up the gains for this iteration
+        if (!turnSize) turnSize = radToDeg(angularError);
+        scheduleGains(lateralPID, lateralSettings, lateralError, speed.y, profileDist);
+        scheduleGains(angularPID, angularSettings, radToDeg(angularError), radToDeg(speed.theta), *turnSize);
 
         // get output from PIDs
-        float lateralOut = lateralPID.update(lateralError);
-        float angularOut = angularPID.update(radToDeg(angularError));
+        float lateralOut;
+        if (profile) {
+            // feed forward the profile velocity, and use the PID to correct how far behind or ahead of it the robot is
+            const ProfileState state = profile->sample(elapsed);
+            const float traveled = profileDist == 0 ? 0 : (pose - start) * (target - start) / profileDist;
+            // use the drivetrain model if it has been characterized, otherwise assume output is proportional to speed
+            const float feedforward = lateralSettings.kV != 0
+                                          ? lateralSettings.feedforward(state.velocity, state.acceleration)
+                                          : state.velocity / maxVelocity * 127;
+            const float profileError = state.position - traveled;
+            if (seedPIDs) lateralPID.reset(profileError);
+            lateralOut = feedforward + lateralPID.update(profileError, dt);
+            if (!params.forwards) lateralOut = -lateralOut;
+        } else {
+            if (seedPIDs) lateralPID.reset(lateralError);
+            lateralOut = lateralPID.update(lateralError, dt);
+            // overcome static friction until the robot is within the small error range
+            if (fabs(lateralError) > lateralSettings.smallError) lateralOut += lateralSettings.kS * sgn(lateralOut);
+        }
+        if (seedPIDs) angularPID.reset(radToDeg(angularError));
+        seedPIDs = false;
+        float angularOut = angularPID.update(radToDeg(angularError), dt);
+        if (fabs(radToDeg(angularError)) > angularSettings.smallError)
+            angularOut += angularSettings.kS * sgn(angularOut);
         if (close) angularOut = 0;
 
         // apply restrictions on angular speed
@@ -86,13 +160,21 @@ void lemlib::Chassis::moveToPoint(float x, float y, int timeout, MoveToPointPara
 
         // apply restrictions on lateral speed
         lateralOut = std::clamp(lateralOut, -params.maxSpeed, params.maxSpeed);
+        // slow down for the corner into the queued motion
+        if (params.blend && params.minSpeed != 0 && !profile) {
+            const float blendSpeed = getBlendSpeed(target, target.theta, distTarget, params.minSpeed, params.maxSpeed,
+                                                  params.forwards);
+            lateralOut = std::clamp(lateralOut, -blendSpeed, blendSpeed);
+        }
         // constrain lateral output by max accel
         // but not for decelerating, since that would interfere with settling
-        if (!close) lateralOut = slew(lateralOut, prevLateralOut, lateralSettings.slew);
+        // the profile already limits acceleration, so it doesn't need to be slewed
+        if (!close && !profile) lateralOut = slew(lateralOut, prevLateralOut, lateralSettings.slew);
 
         // prevent moving in the wrong direction
-        if (params.forwards && !close) lateralOut = std::fmax(lateralOut, 0);
-        else if (!params.forwards && !close) lateralOut = std::fmin(lateralOut, 0);
+        // the profile is allowed to brake if the robot gets ahead of it
+        if (params.forwards && !close && !profile) lateralOut = std::fmax(lateralOut, 0);
+        else if (!params.forwards && !close && !profile) lateralOut = std::fmin(lateralOut, 0);
 
         // constrain lateral output by the minimum speed
         if (params.forwards && lateralOut < fabs(params.minSpeed) && lateralOut > 0) lateralOut = fabs(params.minSpeed);
@@ -103,7 +185,7 @@ void lemlib::Chassis::moveToPoint(float x, float y, int timeout, MoveToPointPara
         prevAngularOut = angularOut;
         prevLateralOut = lateralOut;
 
-        infoSink()->debug("Angular Out: {}, Lateral Out: {}", angularOut, lateralOut);
+        LEMLIB_DEBUG(infoSink(), "Angular Out: {}, Lateral Out: {}", angularOut, lateralOut);
 
         // ratio the speeds to respect the max speed
         float leftPower = lateralOut + angularOut;
@@ -115,16 +197,17 @@ void lemlib::Chassis::moveToPoint(float x, float y, int timeout, MoveToPointPara
         }
 
         // move the drivetrain
-        drivetrain.leftMotors->move(leftPower);
-        drivetrain.rightMotors->move(rightPower);
+        driveOutput.move(leftPower, rightPower);
+        driveOutput.flush();
+
+        LEMLIB_PROFILE_END();
 
         // delay to save resources
-        pros::delay(10);
+        clock->delay(10);
     }
 
-    // stop the drivetrain
-    drivetrain.leftMotors->move(0);
-    drivetrain.rightMotors->move(0);
+    // stop the drivetrain, unless the queued motion is taking over
+    stopOrHandoff(chained && params.blend, prevLateralOut, prevAngularOut);
     // set distTraveled to -1 to indicate that the function has finished
     distTraveled = -1;
     this->endMotion();
@@ -1,11 +1,18 @@
 #include <cmath>
 #include "lemlib/chassis/chassis.hpp"
+#include "lemlib/chassis/odom.hpp"
 #include "lemlib/logger/logger.hpp"
+#include "lemlib/profiler.hpp"
 #include "lemlib/timer.hpp"
 #include "lemlib/util.hpp"
 #include "pros/misc.hpp"
 
 void lemlib::Chassis::moveToPose(float x, float y, float theta, int timeout, MoveToPoseParams params, bool async) {
+    // let the running motion know where the robot is going next, so it can blend into this motion
+    if (this->isInMotion()) {
+        queuedTarget = Pose(x, y);
+        queuedForwards = params.forwards;
+    }
     // take the mutex
     this->requestMotionStart();
     // were all motions cancelled?
@@ -18,11 +25,18 @@ void lemlib::Chassis::moveToPose(float x, float y, float theta, int timeout, Mov
         return;
     }
 
+    // if the previous motion blended into this one, pick up where it left off instead of starting from rest
+    queuedTarget = std::nullopt;
+    const std::optional<MotionHandoff> handoff = takeHandoff();
+
     // reset PIDs and exit conditions
+    // the output carries over from a handoff, but the errors of the PIDs belonged to the previous target. They are
+    // seeded with the first errors towards this target instead, so the derivative doesn't kick
     lateralPID.reset();
+    angularPID.reset();
+    bool seedPIDs = handoff.has_value();
     lateralLargeExit.reset();
     lateralSmallExit.reset();
-    angularPID.reset();
     angularLargeExit.reset();
     angularSmallExit.reset();
 
@@ -36,18 +50,24 @@ void lemlib::Chassis::moveToPose(float x, float y, float theta, int timeout, Mov
     // initialize vars used between iterations
     Pose lastPose = getPose();
     distTraveled = 0;
-    Timer timer(timeout);
+    Timer timer(timeout, clock);
+    uint32_t prevTime = clock->millis();
     bool close = false;
     bool lateralSettled = false;
     bool prevSameSide = false;
-    float prevLateralOut = 0; // previous lateral power
-    float prevAngularOut = 0; // previous angular power
+    bool chained = false;
+    float prevLateralOut = handoff ? handoff->lateralOut : 0; // previous lateral power
+    float prevAngularOut = handoff ? handoff->angularOut : 0; // previous angular power
     const int compState = pros::competition::get_status();
+    // initial errors, for gain scheduling
+    std::optional<float> moveSize = std::nullopt;
+    std::optional<float> turnSize = std::nullopt;
 
     // main loop
     while (!timer.isDone() &&
            ((!lateralSettled || (!angularLargeExit.getExit() && !angularSmallExit.getExit())) || !close) &&
            this->motionRunning) {
+        LEMLIB_PROFILE(ProfileSection::MOVE_TO_POSE);
         // update position
         const Pose pose = getPose(true, true);
 
@@ -78,7 +98,10 @@ void lemlib::Chassis::moveToPose(float x, float y, float theta, int timeout, Mov
                                 (carrot.x - target.x) * cos(target.theta) + params.earlyExitRange;
         const bool sameSide = robotSide == carrotSide;
         // exit if close
-        if (!sameSide && prevSameSide && close && params.minSpeed != 0) break;
+        if (!sameSide && prevSameSide && close && params.minSpeed != 0) {
+            chained = true;
+            break;
+        }
         prevSameSide = sameSide;
 
         // calculate error
@@ -93,20 +116,47 @@ void lemlib::Chassis::moveToPose(float x, float y, float theta, int timeout, Mov
         else lateralError *= sgn(cos(angleError(pose.theta, pose.angle(carrot))));
 
         // update exit conditions
-        lateralSmallExit.update(lateralError);
-        lateralLargeExit.update(lateralError);
-        angularSmallExit.update(radToDeg(angularError));
-        angularLargeExit.update(radToDeg(angularError));
+        const uint32_t now = clock->millis();
+        const float dt = now - prevTime;
+        prevTime = now;
+        const Pose speed = getLocalSpeed(true);
+        lateralSmallExit.update(lateralError, now, speed.y);
+        lateralLargeExit.update(lateralError, now);
+        angularSmallExit.update(radToDeg(angularError), now, radToDeg(speed.theta));
+        angularLargeExit.update(radToDeg(angularError), now);
+        binaryTelemetry().send(TelemetryChannel::CONTROLLER_ERROR, {lateralError, radToDeg(angularError)});
+
+        // look up the gains for this iteration
+        if (!moveSize) moveSize = distTarget;
+        if (!turnSize) turnSize = radToDeg(angularError);
+        scheduleGains(lateralPID, lateralSettings, lateralError, speed.y, *moveSize);
+        scheduleGains(angularPID, angularSettings, radToDeg(angularError), radToDeg(speed.theta), *turnSize);
 
         // get output from PIDs
-        float lateralOut = lateralPID.update(lateralError);
-        float angularOut = angularPID.update(radToDeg(angularError));
+        if (seedPIDs) {
+            lateralPID.reset(lateralError);
+            angularPID.reset(radToDeg(angularError));
+            seedPIDs = false;
+        }
+        float lateralOut = lateralPID.update(lateralError, dt);
+        float angularOut = angularPID.update(radToDeg(angularError), dt);
+
+        // overcome static friction until the robot is within the small error range
+        if (fabs(lateralError) > lateralSettings.smallError) lateralOut += lateralSettings.kS * sgn(lateralOut);
+        if (fabs(radToDeg(angularError)) > angularSettings.smallError)
+            angularOut += angularSettings.kS * sgn(angularOut);
 
         // apply restrictions on angular speed
         angularOut = std::clamp(angularOut, -params.maxSpeed, params.maxSpeed);
 
         // apply restrictions on lateral speed
         lateralOut = std::clamp(lateralOut, -params.maxSpeed, params.maxSpeed);
+        // slow down for the corner into the queued motion
+        if (params.blend && params.minSpeed != 0) {
+            const float blendSpeed = getBlendSpeed(target, target.theta, distTarget, params.minSpeed, params.maxSpeed,
+                                                  params.forwards);
+            lateralOut = std::clamp(lateralOut, -blendSpeed, blendSpeed);
+        }
 
         // constrain lateral output by max accel
         if (!close) lateralOut = slew(lateralOut, prevLateralOut, lateralSettings.slew);
@@ -133,7 +183,7 @@ void lemlib::Chassis::moveToPose(float x, float y, float theta, int timeout, Mov
         prevAngularOut = angularOut;
         prevLateralOut = lateralOut;
 
-        infoSink()->debug("lateralOut: {} angularOut: {}", lateralOut, angularOut);
+        LEMLIB_DEBUG(infoSink(), "lateralOut: {} angularOut: {}", lateralOut, angularOut);
 
         // ratio the speeds to respect the max speed
         float leftPower = lateralOut + angularOut;
@@ -145,16 +195,17 @@ void lemlib::Chassis::moveToPose(float x, float y, float theta, int timeout, Mov
         }
 
         // move the drivetrain
-        drivetrain.leftMotors->move(leftPower);
-        drivetrain.rightMotors->move(rightPower);
+        driveOutput.move(leftPower, rightPower);
+        driveOutput.flush();
+
+        LEMLIB_PROFILE_END();
 
         // delay to save resources
-        pros::delay(10);
+        clock->delay(10);
     }
 
-    // stop the drivetrain
-    drivetrain.leftMotors->move(0);
-    drivetrain.rightMotors->move(0);
+    // stop the drivetrain, unless the queued motion is taking over
+    stopOrHandoff(chained && params.blend, prevLateralOut, prevAngularOut);
     // set distTraveled to -1 to indicate that the function has finished
     distTraveled = -1;
     this->endMotion();
@@ -8,7 +8,10 @@
 #include <string>
 #include "pros/misc.hpp"
 #include "lemlib/logger/logger.hpp"
+#include "lemlib/profiler.hpp"
 #include "lemlib/chassis/chassis.hpp"
+#include "lemlib/chassis/path.hpp"
+#include "lemlib/timer.hpp"
 #include "lemlib/util.hpp"
 
 /**
@@ -54,13 +57,7 @@ std::string stringToHex(const std::string& input) {
     return output;
 }
 
-/**
- * @brief Get a path from the sd card
- *
- * @param filePath The file to read from
- * @return std::vector<lemlib::Pose> vector of points on the path
- */
-std::vector<lemlib::Pose> getData(const asset& path) {
+std::vector<lemlib::Pose> lemlib::readPath(const asset& path) {
     std::vector<lemlib::Pose> robotPath;
 
     // format data from the asset
@@ -69,7 +66,7 @@ std::vector<lemlib::Pose> getData(const asset& path) {
 
     // read the points until 'endData' is read
     for (std::string line : dataLines) {
-        lemlib::infoSink()->debug("read raw line {}", stringToHex(line));
+        LEMLIB_DEBUG(lemlib::infoSink(), "read raw line {}", stringToHex(line));
         if (line == "endData" || line == "endData\r") break;
         const std::vector<std::string> pointInput = readElement(line, ", "); // parse line
         // check if the line was read correctly
@@ -83,7 +80,7 @@ std::vector<lemlib::Pose> getData(const asset& path) {
         pathPoint.y = std::stof(pointInput.at(1)); // y position
         pathPoint.theta = std::stof(pointInput.at(2)); // velocity
         robotPath.push_back(pathPoint); // save data
-        lemlib::infoSink()->debug("read point {}", pathPoint);
+        LEMLIB_DEBUG(lemlib::infoSink(), "read point {}", pathPoint);
     }
 
     return robotPath;
@@ -213,7 +210,10 @@ void lemlib::Chassis::follow(const asset& path, float lookahead, int timeout, bo
         return;
     }
 
-    std::vector<lemlib::Pose> pathPoints = getData(path); // get list of path points
+    // only lateral motions pick up from a blend, so the handoff is dropped instead of left for a later motion
+    takeHandoff();
+
+    std::vector<lemlib::Pose> pathPoints = readPath(path); // get list of path points
     if (pathPoints.size() == 0) {
         infoSink()->error("No points in path! Do you have the right format? Skipping motion");
         // set distTraveled to -1 to indicate that the function has finished
@@ -237,9 +237,18 @@ void lemlib::Chassis::follow(const asset& path, float lookahead, int timeout, bo
     float prevVel = 0;
     int compState = pros::competition::get_status();
     distTraveled = 0;
+    PID leftVelocityPID(velocitySettings.kP, velocitySettings.kI, velocitySettings.kD);
+    PID rightVelocityPID(velocitySettings.kP, velocitySettings.kI, velocitySettings.kD);
+    const bool velocityControlled = velocitySettings.kP != 0 || velocitySettings.kI != 0 || velocitySettings.kD != 0;
+    Timer timer(timeout, clock);
+    uint32_t prevTime = clock->millis();
 
     // loop until the robot is within the end tolerance
-    for (int i = 0; i < timeout / 10 && pros::competition::get_status() == compState && this->motionRunning; i++) {
+    while (!timer.isDone() && pros::competition::get_status() == compState && this->motionRunning) {
+        LEMLIB_PROFILE(ProfileSection::FOLLOW);
+        const uint32_t now = clock->millis();
+        const float dt = now - prevTime;
+        prevTime = now;
         // get the current position of the robot
         pose = this->getPose(true);
         if (!forwards) pose.theta -= M_PI;
@@ -277,25 +286,53 @@ void lemlib::Chassis::follow(const asset& path, float lookahead, int timeout, bo
             targetRightVel /= ratio;
         }
 
+        // find the velocities of the physical sides of the drivetrain
+        const float leftVel = forwards ? targetLeftVel : -targetRightVel;
+        const float rightVel = forwards ? targetRightVel : -targetLeftVel;
+
+        // if a velocity controller has been set, convert the velocities to inches per second and track them in
+        // closed loop: feed forward through the drivetrain model, and correct using the measured wheel velocities.
+        // Otherwise, send the velocities as power
+        float leftPower = leftVel;
+        float rightPower = rightVel;
+        if (velocityControlled) {
+            const float toInches = drivetrain.rpm * drivetrain.wheelDiameter * M_PI / 60 / 127;
+            // the first iteration has no previous time, so assume the usual period
+            const float seconds = dt > 0 ? dt / 1000 : 0.01;
+            const float leftAccel = (leftVel - prevLeftVel) * toInches / seconds;
+            const float rightAccel = (rightVel - prevRightVel) * toInches / seconds;
+            // without a kV there is no drivetrain model, so feed forward the velocities as power, the same as the
+            // motion profile of moveToPoint
+            const bool modelled = lateralSettings.kV != 0;
+            leftPower = (modelled ? lateralSettings.feedforward(leftVel * toInches, leftAccel) : leftVel) +
+                        leftVelocityPID.update(leftVel * toInches - getWheelVelocity(DriveSide::LEFT), dt);
+            rightPower = (modelled ? lateralSettings.feedforward(rightVel * toInches, rightAccel) : rightVel) +
+                         rightVelocityPID.update(rightVel * toInches - getWheelVelocity(DriveSide::RIGHT), dt);
+            // the corrections can push a side past the max power. Scale both sides down together, so the robot
+            // still follows the same curvature
+            const float powerRatio = std::max(std::fabs(leftPower), std::fabs(rightPower)) / 127;
+            if (powerRatio > 1) {
+                leftPower /= powerRatio;
+                rightPower /= powerRatio;
+            }
+        }
+
         // update previous velocities
-        prevLeftVel = targetLeftVel;
-        prevRightVel = targetRightVel;
+        prevLeftVel = leftVel;
+        prevRightVel = rightVel;
 
         // move the drivetrain
-        if (forwards) {
-            drivetrain.leftMotors->move(targetLeftVel);
-            drivetrain.rightMotors->move(targetRightVel);
-        } else {
-            drivetrain.leftMotors->move(-targetRightVel);
-            drivetrain.rightMotors->move(-targetLeftVel);
-        }
+        driveOutput.move(leftPower, rightPower);
+        driveOutput.flush();
+
+        LEMLIB_PROFILE_END();
 
-        pros::delay(10);
+        clock->delay(10);
     }
 
     // stop the robot
-    drivetrain.leftMotors->move(0);
-    drivetrain.rightMotors->move(0);
+    driveOutput.move(0, 0);
+    driveOutput.flush();
     // set distTraveled to -1 to indicate that the function has finished
     distTraveled = -1;
     // give the mutex back
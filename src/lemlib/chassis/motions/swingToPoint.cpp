@@ -1,6 +1,8 @@
 #include <cmath>
 #include "lemlib/chassis/chassis.hpp"
+#include "lemlib/chassis/odom.hpp"
 #include "lemlib/logger/logger.hpp"
+#include "lemlib/profiler.hpp"
 #include "lemlib/timer.hpp"
 #include "lemlib/util.hpp"
 #include "pros/misc.hpp"
@@ -18,17 +20,26 @@ void lemlib::Chassis::swingToPoint(float x, float y, DriveSide lockedSide, int t
         pros::delay(10); // delay to give the task time to start
         return;
     }
+
+    // only lateral motions pick up from a blend, so the handoff is dropped instead of left for a later motion
+    takeHandoff();
+
     float targetTheta;
     float deltaX, deltaY, deltaTheta;
     float motorPower;
     float prevMotorPower = 0;
-    float startTheta = getPose().theta;
+    const Pose startPose = getPose();
+    float startTheta = startPose.theta;
+    // initial angular error, for gain scheduling
+    const float turnSize = angleError(radToDeg(M_PI_2 - atan2(y - startPose.y, x - startPose.x)),
+                                      params.forwards ? startTheta : startTheta - 180, false, params.direction);
     bool settling = false;
     std::optional<float> prevRawDeltaTheta = std::nullopt;
     std::optional<float> prevDeltaTheta = std::nullopt;
     std::uint8_t compState = pros::competition::get_status();
     distTraveled = 0;
-    Timer timer(timeout);
+    Timer timer(timeout, clock);
+    uint32_t prevTime = clock->millis();
     angularLargeExit.reset();
     angularSmallExit.reset();
     angularPID.reset();
@@ -42,6 +53,7 @@ void lemlib::Chassis::swingToPoint(float x, float y, DriveSide lockedSide, int t
 
     // main loop
     while (!timer.isDone() && !angularLargeExit.getExit() && !angularSmallExit.getExit() && this->motionRunning) {
+        LEMLIB_PROFILE(ProfileSection::SWING_TO_POINT);
         // update variables
         Pose pose = getPose();
         pose.theta = (params.forwards) ? fmod(pose.theta, 360) : fmod(pose.theta - 180, 360);
@@ -69,9 +81,16 @@ void lemlib::Chassis::swingToPoint(float x, float y, DriveSide lockedSide, int t
         if (params.minSpeed != 0 && sgn(deltaTheta) != sgn(prevDeltaTheta)) break;
 
         // calculate the speed
-        motorPower = angularPID.update(deltaTheta);
-        angularLargeExit.update(deltaTheta);
-        angularSmallExit.update(deltaTheta);
+        const float angularSpeed = radToDeg(getLocalSpeed(true).theta);
+        scheduleGains(angularPID, angularSettings, deltaTheta, angularSpeed, turnSize);
+        const uint32_t now = clock->millis();
+        motorPower = angularPID.update(deltaTheta, now - prevTime);
+        prevTime = now;
+        // overcome static friction until the robot is within the small error range
+        if (fabs(deltaTheta) > angularSettings.smallError) motorPower += angularSettings.kS * sgn(motorPower);
+        angularLargeExit.update(deltaTheta, now);
+        angularSmallExit.update(deltaTheta, now, angularSpeed);
+        binaryTelemetry().send(TelemetryChannel::CONTROLLER_ERROR, {0, deltaTheta});
 
         // cap the speed
         if (motorPower > params.maxSpeed) motorPower = params.maxSpeed;
@@ -81,18 +100,21 @@ void lemlib::Chassis::swingToPoint(float x, float y, DriveSide lockedSide, int t
         else if (motorPower > 0 && motorPower < params.minSpeed) motorPower = params.minSpeed;
         prevMotorPower = motorPower;
 
-        infoSink()->debug("Turn Motor Power: {} ", motorPower);
+        LEMLIB_DEBUG(infoSink(), "Turn Motor Power: {} ", motorPower);
 
         // move the drivetrain
         if (lockedSide == DriveSide::LEFT) {
-            drivetrain.rightMotors->move(-motorPower);
-            drivetrain.leftMotors->brake();
+            driveOutput.moveRight(-motorPower);
+            driveOutput.brakeLeft();
         } else {
-            drivetrain.leftMotors->move(motorPower);
-            drivetrain.rightMotors->brake();
+            driveOutput.moveLeft(motorPower);
+            driveOutput.brakeRight();
         }
+        driveOutput.flush();
+
+        LEMLIB_PROFILE_END();
 
-        pros::delay(10);
+        clock->delay(10);
     }
 
     // set the brake mode of the locked side of the drivetrain to its
@@ -100,8 +122,8 @@ void lemlib::Chassis::swingToPoint(float x, float y, DriveSide lockedSide, int t
     if (lockedSide == DriveSide::LEFT) this->drivetrain.leftMotors->set_brake_mode_all(brakeMode);
     else this->drivetrain.rightMotors->set_brake_mode_all(brakeMode);
     // stop the drivetrain
-    drivetrain.leftMotors->move(0);
-    drivetrain.rightMotors->move(0);
+    driveOutput.move(0, 0);
+    driveOutput.flush();
     // set distTraveled to -1 to indicate that the function has finished
     distTraveled = -1;
     this->endMotion();
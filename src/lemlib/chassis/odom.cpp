@@ -6,6 +6,8 @@
 #include <math.h>
 #include "pros/rtos.hpp"
 #include "lemlib/util.hpp"
+#include "lemlib/profiler.hpp"
+#include "lemlib/logger/binaryTelemetry.hpp"
 #include "lemlib/chassis/odom.hpp"
 #include "lemlib/chassis/chassis.hpp"
 #include "lemlib/chassis/trackingWheel.hpp"
@@ -73,6 +75,7 @@ lemlib::Pose lemlib::estimatePose(float time, bool radians) {
 }
 
 void lemlib::update() {
+    LEMLIB_PROFILE(ProfileSection::ODOMETRY);
     // TODO: add particle filter
     // get the current sensor values
     float vertical1Raw = 0;
@@ -187,6 +190,10 @@ void lemlib::init() {
         trackingTask = new pros::Task {[=] {
             while (true) {
                 update();
+                const Pose pose = getPose();
+                const Pose speed = getLocalSpeed();
+                binaryTelemetry().send(TelemetryChannel::POSE, {pose.x, pose.y, pose.theta});
+                binaryTelemetry().send(TelemetryChannel::VELOCITY, {speed.y, speed.theta});
                 pros::delay(10);
             }
         }};
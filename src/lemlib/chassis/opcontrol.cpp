@@ -8,12 +8,11 @@ ExpoDriveCurve defaultDriveCurve = ExpoDriveCurve(0, 0, 1);
 
 void Chassis::tank(int left, int right, bool disableDriveCurve) {
     if (disableDriveCurve) {
-        drivetrain.leftMotors->move(left);
-        drivetrain.rightMotors->move(right);
+        driveOutput.move(left, right);
     } else {
-        drivetrain.leftMotors->move(throttleCurve->curve(left));
-        drivetrain.rightMotors->move(throttleCurve->curve(right));
+        driveOutput.move(throttleCurve->curve(left), throttleCurve->curve(right));
     }
+    driveOutput.flush();
 }
 
 void Chassis::arcade(int throttle, int turn, bool disableDriveCurve, float desaturateBias) {
@@ -40,8 +39,8 @@ void Chassis::arcade(int throttle, int turn, bool disableDriveCurve, float desat
     int rightPower = throttle - turn;
 
     // move drive
-    drivetrain.leftMotors->move(leftPower);
-    drivetrain.rightMotors->move(rightPower);
+    driveOutput.move(leftPower, rightPower);
+    driveOutput.flush();
 }
 
 void Chassis::curvature(int throttle, int turn, bool disableDriveCurve) {
@@ -66,7 +65,7 @@ void Chassis::curvature(int throttle, int turn, bool disableDriveCurve) {
         leftPower /= max;
         rightPower /= max;
     }
-    drivetrain.leftMotors->move(leftPower);
-    drivetrain.rightMotors->move(rightPower);
+    driveOutput.move(leftPower, rightPower);
+    driveOutput.flush();
 }
 } // namespace lemlib
@@ -0,0 +1,306 @@
+#include <algorithm>
+#include <cmath>
+#include "lemlib/chassis/path.hpp"
+#include "lemlib/chassis/routineEstimator.hpp"
+#include "lemlib/logger/logger.hpp"
+#include "lemlib/motionProfile.hpp"
+#include "lemlib/util.hpp"
+
+// without a slew limit, the drivetrain is assumed to reach its top speed in this many seconds
+constexpr float UNLIMITED_ACCEL_TIME = 0.25;
+// number of segments the boomerang curve of moveToPose is split into to measure it
+constexpr int CURVE_SEGMENTS = 16;
+// period of the control loop of every motion, in milliseconds
+constexpr float PERIOD = 10;
+// fraction of the free speed of the motors the drivetrain reaches under the load of the robot
+constexpr float LOADED_SPEED = 0.8;
+// how long the drivetrain takes to follow a change of power, in seconds. Makes the controllers overshoot
+constexpr float VELOCITY_LAG = 0.2;
+
+/**
+ * @brief One controller of a motion, stepped every period the same way the motion steps its PID
+ */
+class ControlLoop {
+    public:
+        /**
+         * @param error distance to the target, in the units of the controller
+         * @param maxSpeed max power, out of 127
+         * @param minSpeed min power, out of 127. The controller exits once it reaches the target instead of settling
+         * @param freeSpeed how fast the robot moves at full power, in the units of the controller per second
+         * @param settings settings of the controller
+         */
+        ControlLoop(float error, float maxSpeed, float minSpeed, float freeSpeed,
+                    const lemlib::ControllerSettings& settings)
+            : error(std::fabs(error)),
+              prevError(this->error),
+              maxSpeed(std::fabs(maxSpeed)),
+              minSpeed(std::fabs(minSpeed)),
+              freeSpeed(freeSpeed),
+              settings(settings) {}
+
+        /**
+         * @brief Run the controller for a period
+         *
+         * @param scale fraction of the output that moves the robot towards the target
+         */
+        void step(float scale = 1) {
+            float output = settings.kP * error + settings.kD * (error - prevError);
+            prevError = error;
+            output = std::clamp(output, -maxSpeed, maxSpeed);
+            // the slew only limits speeding up
+            if (settings.slew > 0 && std::fabs(output) > std::fabs(prevOutput))
+                output = std::clamp(output, prevOutput - settings.slew, prevOutput + settings.slew);
+            if (minSpeed != 0) output = std::fmax(output, minSpeed);
+            prevOutput = output;
+            // the drivetrain lags behind the power it is given
+            const float target = output / 127 * freeSpeed * LOADED_SPEED * scale;
+            velocity += (target - velocity) * std::fmin(PERIOD / 1000 / VELOCITY_LAG, 1);
+            error -= velocity * PERIOD / 1000;
+            // the exit conditions count how long the error has been in their range
+            smallTime = std::fabs(error) < settings.smallError ? smallTime + PERIOD : 0;
+            largeTime = std::fabs(error) < settings.largeError ? largeTime + PERIOD : 0;
+        }
+
+        /**
+         * @brief Whether the motion would exit
+         */
+        bool done() const {
+            if (minSpeed != 0) return error <= 0;
+            return (settings.smallError > 0 && smallTime > settings.smallErrorTimeout) ||
+                   (settings.largeError > 0 && largeTime > settings.largeErrorTimeout);
+        }
+
+        /**
+         * @brief Get the distance left to the target, in the units of the controller
+         */
+        float getError() const { return error; }
+    private:
+        float error;
+        float prevError;
+        float prevOutput = 0;
+        float velocity = 0;
+        float smallTime = 0;
+        float largeTime = 0;
+        const float maxSpeed;
+        const float minSpeed;
+        const float freeSpeed;
+        const lemlib::ControllerSettings& settings;
+};
+
+namespace lemlib {
+RoutineEstimator::RoutineEstimator(Drivetrain drivetrain, ControllerSettings linearSettings,
+                                   ControllerSettings angularSettings, float budget)
+    : drivetrain(drivetrain),
+      linearSettings(linearSettings),
+      angularSettings(angularSettings),
+      budget(budget) {}
+
+void RoutineEstimator::setPose(float x, float y, float theta) { pose = Pose(x, y, theta); }
+
+float RoutineEstimator::getMaxVelocity() const { return drivetrain.rpm * drivetrain.wheelDiameter * M_PI / 60; }
+
+float RoutineEstimator::getTurnSpeed(bool swing) const {
+    // a swing only moves one side, so it turns half as fast as turning in place
+    const float radius = swing ? drivetrain.trackWidth : drivetrain.trackWidth / 2;
+    return radToDeg(getMaxVelocity() / radius);
+}
+
+float RoutineEstimator::getAcceleration(float slew) const {
+    if (slew <= 0) return getMaxVelocity() / UNLIMITED_ACCEL_TIME;
+    // slew is how much the power can change every 10 ms
+    return slew / 127 * getMaxVelocity() * 100;
+}
+
+float RoutineEstimator::estimateMotion(float distance, float maxSpeed, float minSpeed, float freeSpeed, float timeout,
+                                       const ControllerSettings& settings) const {
+    ControlLoop loop(distance, maxSpeed, minSpeed, freeSpeed, settings);
+    // one period past the timeout marks the motion as timing out
+    float time = 0;
+    while (time <= timeout && !loop.done()) {
+        loop.step();
+        time += PERIOD;
+    }
+    return time;
+}
+
+float RoutineEstimator::estimateDrive(float distance, float maxSpeed, float minSpeed, float timeout,
+                                     float heading) const {
+    ControlLoop lateral(distance, maxSpeed, minSpeed, getMaxVelocity(), linearSettings);
+    ControlLoop angular(heading, maxSpeed, 0, getTurnSpeed(false), angularSettings);
+    float time = 0;
+    while (time <= timeout && !lateral.done()) {
+        // the robot turns towards the target while it drives, and only the part of the drive along its heading
+        // brings it closer
+        angular.step();
+        lateral.step(std::fmax(std::cos(degToRad(angular.getError())), 0));
+        time += PERIOD;
+    }
+    return time;
+}
+
+float RoutineEstimator::estimateTurn(float angle, float maxSpeed, float minSpeed, bool swing, float timeout) const {
+    return estimateMotion(angle, maxSpeed, minSpeed, getTurnSpeed(swing), timeout, angularSettings);
+}
+
+void RoutineEstimator::add(const std::string& name, float duration, float timeout) {
+    const bool timesOut = duration > timeout;
+    motions.push_back({name, int(motions.size()), std::fmin(duration, timeout), timeout, timesOut});
+}
+
+void RoutineEstimator::moveToPoint(float x, float y, int timeout, MoveToPointParams params) {
+    const Pose target(x, y);
+    const float distance = pose.distance(target);
+    const float exitDistance = params.minSpeed != 0 ? std::fmax(distance - params.earlyExitRange, 0) : distance;
+    // the robot ends up facing the direction it drove in
+    const float heading = distance > 0 ? 90 - radToDeg(pose.angle(target)) + (params.forwards ? 0 : 180) : pose.theta;
+    if (params.profiled && params.minSpeed == 0) {
+        // the robot follows the profile, then settles
+        const float maxAccel = params.maxAccel != 0 ? std::fabs(params.maxAccel) : getAcceleration(linearSettings.slew);
+        const float velocity = params.maxSpeed / 127 * getMaxVelocity();
+        const MotionProfile profile(distance, velocity, maxAccel, std::fabs(params.maxJerk));
+        add("moveToPoint", profile.getDuration() * 1000 + linearSettings.smallErrorTimeout, timeout);
+    } else {
+        const float turn = angleError(heading, pose.theta, false);
+        add("moveToPoint", estimateDrive(exitDistance, params.maxSpeed, params.minSpeed, timeout, turn), timeout);
+    }
+    pose = Pose(x, y, heading);
+}
+
+void RoutineEstimator::moveToPose(float x, float y, float theta, int timeout, MoveToPoseParams params) {
+    const Pose target(x, y, degToRad(theta));
+    const Pose start(pose.x, pose.y);
+    // the robot follows a curve from its start, pulled towards the carrot point. A robot driving backwards
+    // approaches the target from in front of it
+    const float direction = params.forwards ? 1 : -1;
+    const float lead = pose.distance(target) * params.lead * direction;
+    const Pose carrot(x - lead * std::sin(target.theta), y - lead * std::cos(target.theta));
+    std::vector<Pose> curve = {start};
+    for (int i = 1; i <= CURVE_SEGMENTS; i++) {
+        const float t = float(i) / CURVE_SEGMENTS;
+        curve.push_back(start * ((1 - t) * (1 - t)) + carrot * (2 * (1 - t) * t) + Pose(x, y) * (t * t));
+    }
+    // moveToPose slows down on tight corners so the robot doesn't slip, so find the speed that would cover the curve
+    // in the same time as the corner speed limits do
+    const float drift = params.horizontalDrift != 0 ? params.horizontalDrift : drivetrain.horizontalDrift;
+    float length = 0;
+    float slowness = 0; // length divided by speed
+    for (size_t i = 1; i < curve.size(); i++) {
+        const float segment = curve[i - 1].distance(curve[i]);
+        float speed = std::fabs(params.maxSpeed);
+        if (i + 1 < curve.size() && drift > 0) {
+            // radius of the circle through 3 consecutive points
+            const Pose a = curve[i - 1];
+            const Pose b = curve[i];
+            const Pose c = curve[i + 1];
+            const float cross = std::fabs((b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x));
+            if (cross > 0) {
+                const float radius = a.distance(b) * b.distance(c) * c.distance(a) / (2 * cross);
+                speed = std::fmin(speed, std::sqrt(drift * radius * 9.8));
+            }
+        }
+        length += segment;
+        if (speed > 0) slowness += segment / speed;
+    }
+    const float speed = slowness > 0 ? length / slowness : params.maxSpeed;
+    const float exitLength = params.minSpeed != 0 ? std::fmax(length - params.earlyExitRange, 0) : length;
+    // the robot starts by turning towards the carrot point
+    const float carrotHeading = 90 - radToDeg(start.angle(carrot)) + (params.forwards ? 0 : 180);
+    const float turn = angleError(carrotHeading, pose.theta, false);
+    add("moveToPose", estimateDrive(exitLength, speed, params.minSpeed, timeout, turn), timeout);
+    pose = Pose(x, y, theta);
+}
+
+void RoutineEstimator::turnToHeading(float theta, int timeout, TurnToHeadingParams params) {
+    const float angle = angleError(theta, pose.theta, false, params.direction);
+    const float exitAngle = params.minSpeed != 0 ? std::fmax(std::fabs(angle) - params.earlyExitRange, 0) : angle;
+    add("turnToHeading", estimateTurn(exitAngle, params.maxSpeed, params.minSpeed, false, timeout), timeout);
+    pose.theta = theta;
+}
+
+void RoutineEstimator::turnToPoint(float x, float y, int timeout, TurnToPointParams params) {
+    const float theta = 90 - radToDeg(pose.angle(Pose(x, y))) + (params.forwards ? 0 : 180);
+    const float angle = angleError(theta, pose.theta, false, params.direction);
+    const float exitAngle = params.minSpeed != 0 ? std::fmax(std::fabs(angle) - params.earlyExitRange, 0) : angle;
+    add("turnToPoint", estimateTurn(exitAngle, params.maxSpeed, params.minSpeed, false, timeout), timeout);
+    pose.theta = theta;
+}
+
+void RoutineEstimator::swingToHeading(float theta, DriveSide lockedSide, int timeout, SwingToHeadingParams params) {
+    const float angle = angleError(theta, pose.theta, false, params.direction);
+    const float exitAngle = params.minSpeed != 0 ? std::fmax(std::fabs(angle) - params.earlyExitRange, 0) : angle;
+    add("swingToHeading", estimateTurn(exitAngle, params.maxSpeed, params.minSpeed, true, timeout), timeout);
+    // the robot pivots about the wheels of the locked side, so its center moves too
+    const float heading = degToRad(pose.theta);
+    const float side = lockedSide == DriveSide::LEFT ? -1 : 1;
+    const Pose pivot(pose.x + side * drivetrain.trackWidth / 2 * std::cos(heading),
+                     pose.y - side * drivetrain.trackWidth / 2 * std::sin(heading));
+    const Pose center = Pose(pose.x, pose.y).rotate(-degToRad(angle)) - pivot.rotate(-degToRad(angle)) + pivot;
+    pose = Pose(center.x, center.y, theta);
+}
+
+void RoutineEstimator::swingToPoint(float x, float y, DriveSide lockedSide, int timeout, SwingToPointParams params) {
+    const float theta = 90 - radToDeg(pose.angle(Pose(x, y))) + (params.forwards ? 0 : 180);
+    swingToHeading(theta, lockedSide, timeout,
+                   {.direction = params.direction,
+                    .maxSpeed = params.maxSpeed,
+                    .minSpeed = params.minSpeed,
+                    .earlyExitRange = params.earlyExitRange});
+    motions.back().name = "swingToPoint";
+}
+
+void RoutineEstimator::follow(const asset& path, float lookahead, int timeout, bool forwards) {
+    const std::vector<Pose> points = readPath(path);
+    // the velocity of each point in the path is stored in theta, as power out of 127
+    float time = 0;
+    for (size_t i = 1; i < points.size(); i++) {
+        const float velocity = points[i - 1].theta / 127 * getMaxVelocity();
+        if (velocity <= 0) break;
+        time += points[i - 1].distance(points[i]) / velocity;
+    }
+    add("follow", time * 1000, timeout);
+    if (points.size() < 2) return;
+    const Pose& last = points.back();
+    const Pose& secondLast = points[points.size() - 2];
+    pose = Pose(last.x, last.y, 90 - radToDeg(secondLast.angle(last)) + (forwards ? 0 : 180));
+}
+
+void RoutineEstimator::delay(int time) { add("delay", time, time); }
+
+const std::vector<MotionEstimate>& RoutineEstimator::getMotions() const { return motions; }
+
+float RoutineEstimator::getDuration() const {
+    float total = 0;
+    for (const MotionEstimate& motion : motions) total += motion.duration;
+    return total;
+}
+
+bool RoutineEstimator::fitsBudget() const { return getDuration() <= budget; }
+
+std::vector<MotionEstimate> RoutineEstimator::getMostExpensive(size_t count) const {
+    std::vector<MotionEstimate> sorted = motions;
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [](const MotionEstimate& a, const MotionEstimate& b) { return a.duration > b.duration; });
+    if (sorted.size() > count) sorted.resize(count);
+    return sorted;
+}
+
+void RoutineEstimator::report() const {
+    for (const MotionEstimate& motion : motions) {
+        if (motion.timesOut) {
+            infoSink()->warn("Motion {} ({}) is expected to run into its {:.0f} ms timeout", motion.index,
+                             motion.name, motion.timeout);
+        } else infoSink()->info("Motion {} ({}): {:.0f} ms", motion.index, motion.name, motion.duration);
+    }
+    const float duration = getDuration();
+    if (fitsBudget()) {
+        infoSink()->info("Routine takes {:.0f} ms, {:.0f} ms under the {:.0f} ms budget", duration, budget - duration,
+                         budget);
+        return;
+    }
+    infoSink()->warn("Routine takes {:.0f} ms, {:.0f} ms over the {:.0f} ms budget", duration, duration - budget,
+                     budget);
+    for (const MotionEstimate& motion : getMostExpensive()) {
+        infoSink()->warn("Expensive motion {} ({}): {:.0f} ms", motion.index, motion.name, motion.duration);
+    }
+}
+} // namespace lemlib
@@ -0,0 +1,24 @@
+#include "pros/rtos.hpp"
+#include "lemlib/clock.hpp"
+
+namespace lemlib {
+uint32_t RealClock::millis() const { return pros::millis(); }
+
+void RealClock::delay(uint32_t time) { pros::delay(time); }
+
+ManualClock::ManualClock(uint32_t start)
+    : time(start) {}
+
+uint32_t ManualClock::millis() const { return time.load(); }
+
+void ManualClock::delay(uint32_t time) { advance(time); }
+
+void ManualClock::advance(uint32_t time) { this->time += time; }
+
+void ManualClock::set(uint32_t time) { this->time = time; }
+
+Clock* realClock() {
+    static RealClock clock;
+    return &clock;
+}
+} // namespace lemlib
@@ -1,4 +1,5 @@
 #include "lemlib/util.hpp"
+#include "lemlib/profiler.hpp"
 #include <cmath>
 
 namespace lemlib {
@@ -8,6 +9,7 @@ ExpoDriveCurve::ExpoDriveCurve(float deadband, float minOutput, float curve)
       curveGain(curve) {}
 
 float ExpoDriveCurve::curve(float input) {
+    LEMLIB_PROFILE(ProfileSection::DRIVE_CURVE);
     // return 0 if input is within deadzone
     if (fabs(input) <= deadband) return 0;
     // g is the output of g(x) as defined in the Desmos graph
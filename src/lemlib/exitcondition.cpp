@@ -1,24 +1,77 @@
+#include <algorithm>
 #include <cmath>
-#include "pros/rtos.hpp"
 #include "lemlib/exitcondition.hpp"
+#include "lemlib/util.hpp"
 
 namespace lemlib {
 ExitCondition::ExitCondition(const float range, const int time)
     : range(range),
       time(time) {}
 
+ExitCondition::ExitCondition(const float range, const int time, const float maxRate, const float maxVelocity,
+                             const int stopTime)
+    : range(range),
+      time(time),
+      maxRate(std::fabs(maxRate)),
+      maxVelocity(std::fabs(maxVelocity)),
+      stopTime(stopTime) {}
+
 bool ExitCondition::getExit() { return done; }
 
-bool ExitCondition::update(const float input) {
-    const int curTime = pros::millis();
-    if (std::fabs(input) > range) startTime = -1;
-    else if (startTime == -1) startTime = curTime;
-    else if (curTime >= startTime + time) done = true;
+void ExitCondition::setClock(Clock* clock) { this->clock = clock; }
+
+bool ExitCondition::update(const float input) { return update(input, clock->millis()); }
+
+bool ExitCondition::update(const float input, const uint32_t time, const float velocity) {
+    const int curTime = time;
+    // estimate how fast the input is changing, smoothed since the input is differentiated
+    if (prevTime != -1 && curTime > prevTime) {
+        const float newRate = (input - prevInput) * 1000 / (curTime - prevTime);
+        rate = hasRate ? ema(newRate, rate, 0.5) : newRate;
+        hasRate = true;
+    }
+    prevInput = input;
+    prevTime = curTime;
+
+    const bool velocityAware = maxRate != 0 || maxVelocity != 0;
+    const bool coasting = maxVelocity != 0 && std::fabs(velocity) > maxVelocity;
+    const bool stopped = velocityAware && !coasting && (maxRate == 0 || (hasRate && std::fabs(rate) <= maxRate));
+
+    if (std::fabs(input) > range || coasting) {
+        startTime = -1;
+        stopStartTime = -1;
+        return done;
+    }
+    if (!stopped) stopStartTime = -1;
+    else if (stopStartTime == -1) stopStartTime = curTime;
+    else if (curTime >= stopStartTime + stopTime) done = true;
+    if (startTime == -1) startTime = curTime;
+    else if (curTime >= startTime + this->time) done = true;
     return done;
 }
 
+float ExitCondition::predictSettleTime() const {
+    if (done) return 0;
+    // already in range, so only the countdown is left
+    if (startTime != -1) {
+        float remaining = startTime + time - prevTime;
+        if (stopStartTime != -1) remaining = std::min(remaining, float(stopStartTime + stopTime - prevTime));
+        return std::max(remaining, 0.0f);
+    }
+    // extrapolate when the input will reach the range, if it is moving towards it
+    if (!hasRate || rate * prevInput >= 0) return -1;
+    const float timeToRange = (std::fabs(prevInput) - range) / std::fabs(rate) * 1000;
+    const bool velocityAware = maxRate != 0 || maxVelocity != 0;
+    return std::max(timeToRange, 0.0f) + (velocityAware ? std::min(stopTime, time) : time);
+}
+
 void ExitCondition::reset() {
     startTime = -1;
+    stopStartTime = -1;
+    prevTime = -1;
+    prevInput = 0;
+    rate = 0;
+    hasRate = false;
     done = false;
 }
-} // namespace lemlib
\ No newline at end of file
+} // namespace lemlib
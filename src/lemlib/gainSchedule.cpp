@@ -0,0 +1,49 @@
+#include <algorithm>
+#include <cmath>
+#include "lemlib/gainSchedule.hpp"
+
+namespace lemlib {
+std::string format_as(ScheduleVariable variable) {
+    switch (variable) {
+        case ScheduleVariable::ERROR: return "ERROR";
+        case ScheduleVariable::SPEED: return "SPEED";
+        case ScheduleVariable::MOTION_SIZE: return "MOTION_SIZE";
+        default: return "UNKNOWN";
+    }
+}
+
+GainSchedule::GainSchedule(ScheduleVariable variable, std::initializer_list<ScheduledGains> points)
+    : variable(variable),
+      points(points) {
+    // sort the points so the lookup can search for the two around the value
+    std::sort(this->points.begin(), this->points.end(),
+              [](const ScheduledGains& a, const ScheduledGains& b) { return a.value < b.value; });
+}
+
+ScheduleVariable GainSchedule::getVariable() const { return variable; }
+
+ScheduledGains GainSchedule::get(float value) const {
+    if (points.empty()) return {value, 0, 0, 0};
+    // clamp to the ends of the table
+    if (value <= points.front().value) return points.front();
+    if (value >= points.back().value) return points.back();
+    // find the first point above the value, and interpolate between it and the point before it
+    const auto upper = std::upper_bound(points.begin(), points.end(), value,
+                                        [](float value, const ScheduledGains& point) { return value < point.value; });
+    const ScheduledGains& low = *(upper - 1);
+    const ScheduledGains& high = *upper;
+    const float t = (value - low.value) / (high.value - low.value);
+    return {value, std::lerp(low.kP, high.kP, t), std::lerp(low.kI, high.kI, t), std::lerp(low.kD, high.kD, t)};
+}
+
+ScheduledGains GainSchedule::get(float error, float speed, float motionSize) const {
+    switch (variable) {
+        case ScheduleVariable::ERROR: return get(std::fabs(error));
+        case ScheduleVariable::SPEED: return get(std::fabs(speed));
+        case ScheduleVariable::MOTION_SIZE: return get(std::fabs(motionSize));
+        default: return get(std::fabs(error));
+    }
+}
+
+bool GainSchedule::empty() const { return points.empty(); }
+} // namespace lemlib
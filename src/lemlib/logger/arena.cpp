@@ -0,0 +1,59 @@
+#include <algorithm>
+#include <bit>
+#include "lemlib/logger/arena.hpp"
+
+namespace lemlib {
+LogArena::Slab::Slab(LogArena* arena, uint8_t index, char* memory, size_t size)
+    : arena(arena),
+      index(index),
+      memory(memory),
+      size(size) {}
+
+LogArena::Slab::Slab(Slab&& other) noexcept
+    : arena(other.arena),
+      index(other.index),
+      memory(other.memory),
+      size(other.size),
+      overflow(std::move(other.overflow)) {
+    other.arena = nullptr;
+}
+
+LogArena::Slab::~Slab() {
+    if (arena != nullptr) arena->release(index);
+}
+
+LogArena::LogArena(size_t slabSize, uint8_t slabCount)
+    : slabSize(std::max<size_t>(slabSize, 1)),
+      slabCount(std::clamp<uint8_t>(slabCount, 1, 32)),
+      memory(std::make_unique<char[]>(this->slabSize * this->slabCount)) {}
+
+LogArena::Slab LogArena::acquire() {
+    const uint32_t all = slabCount == 32 ? UINT32_MAX : (1u << slabCount) - 1;
+    uint32_t bits = used.load(std::memory_order_relaxed);
+    // claim the lowest free slab. Another task may claim it first, in which case the next free one is tried
+    while ((~bits & all) != 0) {
+        const uint32_t free = ~bits & all;
+        const uint32_t bit = free & -free;
+        if (used.compare_exchange_weak(bits, bits | bit, std::memory_order_acquire, std::memory_order_relaxed)) {
+            const uint8_t index = std::countr_zero(bit);
+            return Slab(this, index, memory.get() + index * slabSize, slabSize);
+        }
+    }
+    overflows++;
+    Slab slab(nullptr, 0, nullptr, slabSize);
+    slab.overflow = std::make_unique<char[]>(slabSize);
+    slab.memory = slab.overflow.get();
+    return slab;
+}
+
+void LogArena::release(uint8_t index) { used.fetch_and(~(1u << index), std::memory_order_release); }
+
+size_t LogArena::getSlabSize() const { return slabSize; }
+
+uint32_t LogArena::getOverflows() const { return overflows; }
+
+LogArena& logArena() {
+    static LogArena logArena;
+    return logArena;
+}
+} // namespace lemlib
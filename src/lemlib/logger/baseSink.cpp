@@ -1,8 +1,22 @@
+#include <cstdio>
 #include "lemlib/logger/baseSink.hpp"
 
 namespace lemlib {
 BaseSink::BaseSink(std::initializer_list<std::shared_ptr<BaseSink>> sinks) { this->sinks = sinks; }
 
+BaseSink::~BaseSink() { stopQueue(); }
+
+void BaseSink::flushDeferred() {
+    while (pendingDeferred.load() > 0) pros::delay(1);
+}
+
+void BaseSink::stopQueue() {
+    // deferred messages may still be printed into the queue, so they are sent first
+    flushDeferred();
+    // destroying the queue writes what is left in it, and waits for its task to stop
+    queue.reset();
+}
+
 void BaseSink::setLowestLevel(Level lowestLevel) {
     if (!sinks.empty()) {
         for (std::shared_ptr<BaseSink> sink : sinks) { sink->setLowestLevel(lowestLevel); }
@@ -12,6 +26,56 @@ void BaseSink::setLowestLevel(Level lowestLevel) {
     this->lowestLevel = lowestLevel;
 }
 
+bool BaseSink::isEnabled(Level level) const {
+    if (!sinks.empty()) {
+        for (const std::shared_ptr<BaseSink>& sink : sinks) {
+            if (sink->isEnabled(level)) return true;
+        }
+        return false;
+    }
+
+    return level >= lowestLevel;
+}
+
+void BaseSink::setDeferred(bool deferred) {
+    if (!sinks.empty()) {
+        for (std::shared_ptr<BaseSink> sink : sinks) { sink->setDeferred(deferred); }
+        return;
+    }
+
+    this->deferred = deferred;
+}
+
+void BaseSink::setSource(uint8_t source) {
+    if (!sinks.empty()) {
+        for (std::shared_ptr<BaseSink> sink : sinks) { sink->setSource(source); }
+        return;
+    }
+
+    this->source = source;
+}
+
+void BaseSink::setQueue(const QueueSettings& settings) {
+    if (!sinks.empty()) {
+        for (std::shared_ptr<BaseSink> sink : sinks) { sink->setQueue(settings); }
+        return;
+    }
+
+    // replacing the queue would lose the messages waiting in it, so it is kept once it has been created
+    if (queue == nullptr) {
+        queue = std::make_unique<Buffer>([this](const std::string& batch) { writeOutput(batch); }, settings.capacity,
+                                         settings.policy, settings.priority);
+    }
+    queue->setRate(settings.rate);
+    queue->setDropPolicy(settings.policy);
+    queue->setReservedSpace(settings.reservedSpace);
+}
+
+void BaseSink::writeOutput(const std::string& batch) {
+    std::fwrite(batch.data(), 1, batch.size(), stdout);
+    std::fflush(stdout);
+}
+
 void BaseSink::setFormat(const std::string& logFormat) { this->logFormat = logFormat; }
 
 fmt::dynamic_format_arg_store<fmt::format_context> BaseSink::getExtraFormattingArgs(const Message& messageInfo) {
@@ -19,4 +83,67 @@ fmt::dynamic_format_arg_store<fmt::format_context> BaseSink::getExtraFormattingA
 }
 
 void BaseSink::sendMessage(const Message& message) {}
+
+Message BaseSink::createMessage(Level level, uint64_t micros, uint32_t sequence, std::string_view messageString,
+                                const LogArena::Slab& line) {
+    Message message = Message {
+        .level = level, .time = uint32_t(micros / 1000), .micros = micros, .source = source, .sequence = sequence};
+
+    // get the arguments
+    fmt::dynamic_format_arg_store<fmt::format_context> formattingArgs = getExtraFormattingArgs(message);
+
+    auto timeArg = fmt::arg("time", message.time);
+    auto levelArg = fmt::arg("level", message.level);
+    auto messageArg = fmt::arg("message", messageString);
+    auto microsArg = fmt::arg("micros", message.micros);
+    auto sourceArg = fmt::arg("source", message.source);
+    auto sequenceArg = fmt::arg("sequence", message.sequence);
+
+    size_t size;
+    if (fmt::format_args(formattingArgs).max_size() == 0) {
+        // without extra arguments, the arguments are stored on the stack instead of being allocated by the store
+        const auto args = fmt::make_format_args(timeArg, levelArg, messageArg, microsArg, sourceArg, sequenceArg);
+        size = fmt::vformat_to_n(line.data(), line.capacity(), logFormat, args).size;
+    } else {
+        formattingArgs.push_back(timeArg);
+        formattingArgs.push_back(levelArg);
+        formattingArgs.push_back(messageArg);
+        formattingArgs.push_back(microsArg);
+        formattingArgs.push_back(sourceArg);
+        formattingArgs.push_back(sequenceArg);
+        size = fmt::vformat_to_n(line.data(), line.capacity(), logFormat, formattingArgs).size;
+    }
+
+    message.message = std::string_view(line.data(), std::min(size, line.capacity()));
+    return message;
+}
+
+void BaseSink::sendDeferred(const std::string& batch) {
+    size_t position = 0;
+    while (position + sizeof(DeferredHeader) <= batch.size()) {
+        // records aren't aligned in the batch, so the header is copied out
+        DeferredHeader header;
+        std::memcpy(&header, batch.data() + position, sizeof(header));
+        const LogArena::Slab text = logArena().acquire();
+        // the format string is at the end of the record, after the arguments
+        const fmt::string_view format(batch.data() + position + header.size - header.formatSize, header.formatSize);
+        const size_t size =
+            header.formatter(format, batch.data() + position + sizeof(header), text.data(), text.capacity());
+        const LogArena::Slab line = logArena().acquire();
+        BaseSink* sink = header.sink;
+        sink->sendMessage(sink->createMessage(header.level, header.micros, header.sequence,
+                                              std::string_view(text.data(), std::min(size, text.capacity())), line));
+        // the sink may be destroyed as soon as this is counted, so it isn't used after
+        sink->pendingDeferred--;
+        position += header.size;
+    }
+}
+
+Buffer& BaseSink::deferredBuffer() {
+    // formatting is the least important work on the brain, so it is done by the lowest priority task
+    static Buffer buffer(sendDeferred, 4096, DropPolicy::DROP_NEWEST, TASK_PRIORITY_MIN);
+    // ERROR and FATAL messages get space of their own, the same as in the queues of sinks. Set once, with the buffer
+    [[maybe_unused]] static const bool reserved = (buffer.setReservedSpace(512), true);
+    return buffer;
+}
 } // namespace lemlib
\ No newline at end of file
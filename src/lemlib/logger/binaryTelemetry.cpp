@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include "pros/rtos.hpp"
+#include "lemlib/logger/binaryTelemetry.hpp"
+
+// how often the schema of every channel is resent, in milliseconds
+constexpr uint32_t SCHEMA_PERIOD = 1000;
+
+namespace lemlib {
+BinaryTelemetry::BinaryTelemetry()
+    : buffer([](const std::string& frames) {
+          // start with a delimiter, so anything printed to the terminal since the last batch is its own frame and gets
+          // discarded, instead of corrupting the first frame of this batch
+          std::fputc(0, stdout);
+          std::fwrite(frames.data(), 1, frames.size(), stdout);
+          std::fflush(stdout);
+      }) {
+    buffer.setRate(10);
+    addChannel("pose", {"x", "y", "theta"});
+    addChannel("velocity", {"linear", "angular"});
+    addChannel("motor_power", {"left", "right"});
+    addChannel("controller_error", {"lateral", "angular"});
+}
+
+uint8_t BinaryTelemetry::addChannel(const std::string& name, std::initializer_list<std::string> fields,
+                                    uint32_t decimation) {
+    const uint8_t id = channelCount.load();
+    if (id >= MAX_CHANNELS || fields.size() > MAX_FIELDS) return INVALID_CHANNEL;
+    channels[id].name = name;
+    channels[id].fields = fields;
+    channels[id].decimation = std::max<uint32_t>(decimation, 1);
+    channelCount.store(id + 1);
+    // resend the schemas so the new channel can be decoded right away
+    schemaSent = false;
+    return id;
+}
+
+void BinaryTelemetry::setDecimation(uint8_t channel, uint32_t decimation) {
+    if (channel >= channelCount) return;
+    channels[channel].decimation = std::max<uint32_t>(decimation, 1);
+}
+
+void BinaryTelemetry::setDecimation(TelemetryChannel channel, uint32_t decimation) {
+    setDecimation(static_cast<uint8_t>(channel), decimation);
+}
+
+void BinaryTelemetry::setEnabled(bool enabled) {
+    this->enabled = enabled;
+    schemaSent = false;
+}
+
+bool BinaryTelemetry::isEnabled() const { return enabled; }
+
+uint32_t BinaryTelemetry::getDropped() const { return buffer.getDropped(); }
+
+void BinaryTelemetry::send(TelemetryChannel channel, std::initializer_list<float> values) {
+    send(static_cast<uint8_t>(channel), values);
+}
+
+void BinaryTelemetry::send(uint8_t id, std::initializer_list<float> values) {
+    if (!enabled.load(std::memory_order_relaxed) || id >= channelCount.load(std::memory_order_acquire)) return;
+    Channel& channel = channels[id];
+    if (channel.count.fetch_add(1, std::memory_order_relaxed) % channel.decimation.load(std::memory_order_relaxed) != 0)
+        return;
+
+    const uint32_t now = pros::millis();
+    uint32_t last = lastSchemaTime.load(std::memory_order_relaxed);
+    // only one task needs to resend the schemas
+    if ((!schemaSent.exchange(true) || now - last >= SCHEMA_PERIOD) &&
+        lastSchemaTime.compare_exchange_strong(last, now)) {
+        sendSchemas();
+    }
+
+    // type, channel id, sequence number, timestamp in microseconds, fields, and CRC
+    std::array<uint8_t, 1 + 1 + sizeof(uint16_t) + sizeof(uint32_t) + MAX_FIELDS * sizeof(float) + 1> frame;
+    size_t size = 0;
+    frame[size++] = static_cast<uint8_t>(FrameType::SAMPLE);
+    frame[size++] = id;
+    const uint16_t number = sequence.fetch_add(1, std::memory_order_relaxed);
+    std::memcpy(frame.data() + size, &number, sizeof(number));
+    size += sizeof(number);
+    // only the low 32 bits are sent. The decoder adds back the rest
+    const uint32_t micros = pros::micros();
+    std::memcpy(frame.data() + size, &micros, sizeof(micros));
+    size += sizeof(micros);
+    const size_t fields = channel.fields.size();
+    auto value = values.begin();
+    for (size_t i = 0; i < fields; i++, size += sizeof(float)) {
+        const float sample = value != values.end() ? *value++ : 0;
+        std::memcpy(frame.data() + size, &sample, sizeof(sample));
+    }
+    frame[size] = crc8(frame.data(), size);
+    pushFrame(frame.data(), size + 1);
+}
+
+void BinaryTelemetry::sendSchemas() {
+    const uint8_t count = channelCount.load(std::memory_order_acquire);
+    for (uint8_t id = 0; id < count; id++) {
+        const Channel& channel = channels[id];
+        // type, channel id, field count, then the name and each field name, each followed by a 0
+        std::vector<uint8_t> frame = {static_cast<uint8_t>(FrameType::SCHEMA), id, uint8_t(channel.fields.size())};
+        frame.insert(frame.end(), channel.name.begin(), channel.name.end());
+        frame.push_back(0);
+        for (const std::string& field : channel.fields) {
+            frame.insert(frame.end(), field.begin(), field.end());
+            frame.push_back(0);
+        }
+        frame.push_back(crc8(frame.data(), frame.size()));
+        pushFrame(frame.data(), frame.size());
+    }
+}
+
+void BinaryTelemetry::pushFrame(const uint8_t* frame, size_t size) {
+    // samples fit on the stack. Schemas are only sent once a second, so they can allocate
+    std::array<uint8_t, 128> small;
+    std::vector<uint8_t> large;
+    uint8_t* encoded = small.data();
+    if (size + size / 254 + 2 > small.size()) {
+        large.resize(size + size / 254 + 2);
+        encoded = large.data();
+    }
+    size_t encodedSize = cobsEncode(frame, size, encoded);
+    encoded[encodedSize++] = 0;
+    buffer.pushToBuffer(reinterpret_cast<const char*>(encoded), encodedSize);
+}
+
+BinaryTelemetry& binaryTelemetry() {
+    static BinaryTelemetry binaryTelemetry;
+    return binaryTelemetry;
+}
+
+uint8_t crc8(const uint8_t* data, size_t size) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < size; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) crc = crc & 0x80 ? (crc << 1) ^ 0x07 : crc << 1;
+    }
+    return crc;
+}
+
+size_t cobsEncode(const uint8_t* data, size_t size, uint8_t* output) {
+    // each block starts with the distance to the next 0, which is replaced by the start of the next block
+    size_t codeIndex = 0;
+    size_t written = 1;
+    uint8_t code = 1;
+    for (size_t i = 0; i < size; i++) {
+        if (data[i] != 0) {
+            output[written++] = data[i];
+            code++;
+        }
+        // a block can only hold 254 bytes, so a full block is ended as if there were a 0
+        if (data[i] == 0 || code == 0xFF) {
+            output[codeIndex] = code;
+            codeIndex = written++;
+            code = 1;
+        }
+    }
+    output[codeIndex] = code;
+    return written;
+}
+
+std::optional<std::vector<uint8_t>> cobsDecode(const uint8_t* data, size_t size) {
+    std::vector<uint8_t> output;
+    output.reserve(size);
+    size_t i = 0;
+    while (i < size) {
+        const uint8_t code = data[i++];
+        if (code == 0 || i + code - 1 > size) return std::nullopt;
+        output.insert(output.end(), data + i, data + i + code - 1);
+        i += code - 1;
+        // a full block isn't followed by a 0, and neither is the last block
+        if (code != 0xFF && i < size) output.push_back(0);
+    }
+    return output;
+}
+} // namespace lemlib
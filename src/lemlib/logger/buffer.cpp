@@ -1,43 +1,163 @@
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstring>
 #define FMT_HEADER_ONLY
 #include "fmt/core.h"
 #include "lemlib/logger/buffer.hpp"
 #include "lemlib/logger/message.hpp"
 
+// size of the header at the start of each record, in bytes
+constexpr uint32_t HEADER_SIZE = sizeof(uint32_t);
+// set in the header of an important record
+constexpr uint32_t IMPORTANT = 1u << 31;
+
+/**
+ * @brief Round a size up to a whole number of words, so every header is aligned
+ */
+static uint32_t recordSize(uint32_t length) {
+    return (HEADER_SIZE + length + HEADER_SIZE - 1) / HEADER_SIZE * HEADER_SIZE;
+}
+
 namespace lemlib {
-Buffer::Buffer(std::function<void(const std::string&)> bufferFunc)
+Buffer::Buffer(std::function<void(const std::string&)> bufferFunc, size_t capacity, DropPolicy policy,
+               std::uint32_t priority)
     : bufferFunc(bufferFunc),
-      task([=]() { taskLoop(); }) {}
+      // wrapping the positions into the ring only works if the capacity is a power of 2
+      capacity(std::max<uint32_t>(std::bit_ceil(capacity), 2 * HEADER_SIZE)),
+      // value initialized, so every header starts out unpublished
+      ring(std::make_unique<uint32_t[]>(this->capacity / HEADER_SIZE)),
+      policy(policy),
+      task([=, this]() { taskLoop(); }, priority) {}
 
-bool Buffer::buffersEmpty() {
-    mutex.take();
-    bool status = buffer.size() == 0;
-    mutex.give();
-    return status;
-}
+bool Buffer::buffersEmpty() { return head.load() == tail.load(); }
 
 Buffer::~Buffer() {
     // make sure when the destructor is called so all
     // the messages are logged
     while (!buffersEmpty()) { pros::delay(10); }
+    // the task uses the buffer, so wait for it to process the last batch and stop
+    closing = true;
+    while (!taskDone) { pros::delay(10); }
 }
 
-void Buffer::pushToBuffer(const std::string& bufferData) {
-    mutex.take();
-    buffer.push_back(bufferData);
-    mutex.give();
+bool Buffer::pushToBuffer(const std::string& bufferData) { return pushToBuffer(bufferData.data(), bufferData.size()); }
+
+bool Buffer::pushToBuffer(const char* data, size_t size, bool important) {
+    const uint32_t length = size;
+    const uint32_t reserved = recordSize(length);
+    // unimportant strings have to leave the reserved space free
+    const uint32_t limit = important ? capacity : capacity - std::min(reservedSpace.load(), capacity);
+    // a string that is larger than the space it can use would never fit. Records are rounded up to whole words, so the
+    // rounded size is checked, the same as when waiting for space below
+    if (size > limit || reserved > limit) {
+        dropped++;
+        return false;
+    }
+
+    // reserve space for the record. Other producers may be reserving space at the same time, so retry until the
+    // reservation wasn't taken by someone else
+    uint32_t start = head.load(std::memory_order_relaxed);
+    do {
+        while (start + reserved - tail.load(std::memory_order_acquire) > limit) {
+            const DropPolicy currentPolicy = policy.load(std::memory_order_relaxed);
+            // the oldest string may still be being copied in, in which case the new one is dropped instead
+            if (currentPolicy == DropPolicy::DROP_NEWEST ||
+                (currentPolicy == DropPolicy::DROP_OLDEST && !discardOldest(important))) {
+                dropped++;
+                return false;
+            }
+            if (currentPolicy == DropPolicy::BLOCK) pros::delay(1);
+            start = head.load(std::memory_order_relaxed);
+        }
+    } while (
+        !head.compare_exchange_weak(start, start + reserved, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+    // copy the string in, then publish it by writing the header
+    copyIn(start + HEADER_SIZE, data, length);
+    const uint32_t header = (length + 1) | (important ? IMPORTANT : 0);
+    std::atomic_ref<uint32_t>(wordAt(start)).store(header, std::memory_order_release);
+    return true;
 }
 
 void Buffer::setRate(uint32_t rate) { this->rate = rate; }
 
-void Buffer::taskLoop() {
+void Buffer::setDropPolicy(DropPolicy policy) { this->policy = policy; }
+
+void Buffer::setReservedSpace(size_t bytes) { reservedSpace = bytes; }
+
+uint32_t Buffer::getDropped() const { return dropped; }
+
+uint32_t& Buffer::wordAt(uint32_t position) { return ring[(position & (capacity - 1)) / HEADER_SIZE]; }
+
+void Buffer::copyIn(uint32_t position, const char* source, uint32_t size) {
+    char* bytes = reinterpret_cast<char*>(ring.get());
+    const uint32_t offset = position & (capacity - 1);
+    const uint32_t first = std::min(size, capacity - offset);
+    std::memcpy(bytes + offset, source, first);
+    std::memcpy(bytes, source + first, size - first);
+}
+
+void Buffer::copyOut(uint32_t position, uint32_t size) {
+    const char* bytes = reinterpret_cast<const char*>(ring.get());
+    const uint32_t offset = position & (capacity - 1);
+    const uint32_t first = std::min(size, capacity - offset);
+    batch.append(bytes + offset, first);
+    batch.append(bytes, size - first);
+}
+
+void Buffer::drain() {
+    tailMutex.take();
+    uint32_t position = tail.load(std::memory_order_relaxed);
     while (true) {
-        mutex.take();
-        if (buffer.size() > 0) {
-            bufferFunc(buffer.at(0));
-            buffer.pop_front();
-        }
-        mutex.give();
+        std::atomic_ref<uint32_t> header(wordAt(position));
+        // stop at the first record that is reserved but still being copied in, so strings stay in order
+        const uint32_t value = header.load(std::memory_order_acquire);
+        if (value == 0) break;
+        const uint32_t length = (value & ~IMPORTANT) - 1;
+        copyOut(position + HEADER_SIZE, length);
+        // clear the record so any word of it reads as an unpublished header when the space is reused, then hand the
+        // space back
+        const uint32_t size = recordSize(length);
+        for (uint32_t i = HEADER_SIZE; i < size; i += HEADER_SIZE) wordAt(position + i) = 0;
+        header.store(0, std::memory_order_relaxed);
+        position += size;
+        tail.store(position, std::memory_order_release);
+    }
+    tailMutex.give();
+}
+
+bool Buffer::discardOldest(bool important) {
+    tailMutex.take();
+    const uint32_t position = tail.load(std::memory_order_relaxed);
+    std::atomic_ref<uint32_t> header(wordAt(position));
+    const uint32_t value = header.load(std::memory_order_acquire);
+    // the ring is empty, the oldest string is still being copied in, or it is more important than the new one
+    if (value == 0 || ((value & IMPORTANT) && !important)) {
+        tailMutex.give();
+        return false;
+    }
+    // the same as draining the string, without copying it out
+    const uint32_t size = recordSize((value & ~IMPORTANT) - 1);
+    for (uint32_t i = HEADER_SIZE; i < size; i += HEADER_SIZE) wordAt(position + i) = 0;
+    header.store(0, std::memory_order_relaxed);
+    tail.store(position + size, std::memory_order_release);
+    dropped++;
+    tailMutex.give();
+    return true;
+}
+
+void Buffer::taskLoop() {
+    // only this task touches the batch, so it is allocated here instead of in the constructor
+    batch.reserve(capacity);
+    while (!closing) {
         pros::delay(rate);
+        drain();
+        if (batch.empty()) continue;
+        bufferFunc(batch);
+        // keeps the preallocated memory
+        batch.clear();
     }
+    taskDone = true;
 }
 } // namespace lemlib
@@ -0,0 +1,209 @@
+#include <algorithm>
+#include <cstring>
+#include "lemlib/logger/fileSink.hpp"
+#include "lemlib/logger/lz4.hpp"
+
+// identifies the start of a segment
+constexpr char MAGIC[4] = {'L', 'L', 'S', 'G'};
+constexpr uint8_t VERSION = 1;
+// set in the flags of a segment whose data is compressed with LZ4
+constexpr uint8_t COMPRESSED = 1;
+// how long a segment can hold messages before it is written, in milliseconds
+constexpr uint32_t FLUSH_PERIOD = 1000;
+// how often the background task checks for a segment to write, in milliseconds
+constexpr uint32_t TASK_PERIOD = 20;
+// most files a prefix can have
+constexpr int MAX_FILES = 1000;
+
+/**
+ * @brief Written before the data of each segment
+ */
+struct SegmentHeader {
+        char magic[4];
+        uint8_t version;
+        uint8_t flags;
+        uint16_t reserved;
+        /** size of the data before compression */
+        uint32_t size;
+        /** size of the data in the file */
+        uint32_t storedSize;
+        uint32_t firstTime;
+        uint32_t lastTime;
+};
+
+/**
+ * @brief An entry in the index of a file, one for each segment
+ */
+struct IndexEntry {
+        /** offset of the segment header in the file */
+        uint32_t offset;
+        uint32_t firstTime;
+        uint32_t lastTime;
+};
+
+static_assert(sizeof(SegmentHeader) == 24 && sizeof(IndexEntry) == 12, "the file format has no padding");
+
+namespace lemlib {
+FileSink::FileSink(const std::string& prefix, size_t segmentSize, bool compress, size_t maxFileSize)
+    : prefix(prefix),
+      segmentSize((std::max(segmentSize, ALIGNMENT) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT),
+      compress(compress),
+      maxFileSize(maxFileSize) {
+    // microseconds, so the file can be merged with other logs and telemetry by sim/build/merge
+    setFormat("{micros} {level}: {message}");
+    // an uncompressed segment fills its share of the file exactly
+    for (Segment& segment : segments) segment.data.resize(this->segmentSize - sizeof(SegmentHeader));
+    if (compress) {
+        compressed.resize(lz4CompressBound(segments[0].data.size()));
+        matchTable.resize(LZ4_TABLE_SIZE);
+    }
+    task = new pros::Task {[this] { taskLoop(); }, TASK_PRIORITY_MIN};
+}
+
+FileSink::~FileSink() {
+    // deferred messages are appended through sendMessage, so they have to be sent before anything is torn down
+    stopQueue();
+    flush();
+    // the task uses the sink, so wait for it to finish before the sink is destroyed
+    closing = true;
+    while (!taskDone) pros::delay(5);
+    delete task;
+    if (file != nullptr) std::fclose(file);
+    if (index != nullptr) std::fclose(index);
+}
+
+void FileSink::sendMessage(const Message& message) {
+    append(message.message.data(), message.message.size(), message.time, true);
+}
+
+bool FileSink::write(const char* data, size_t size) { return append(data, size, pros::millis()); }
+
+bool FileSink::append(const char* data, size_t size, uint32_t time, bool newline) {
+    // the newline is added while copying, so the message doesn't have to be copied to add it
+    const size_t length = size + newline;
+    if (length > segments[0].data.size()) {
+        dropped++;
+        return false;
+    }
+    mutex.take();
+    if (segments[active].used + length > segments[active].data.size() && !handOff()) {
+        mutex.give();
+        dropped++;
+        return false;
+    }
+    Segment& segment = segments[active];
+    std::memcpy(segment.data.data() + segment.used, data, size);
+    if (newline) segment.data[segment.used + size] = '\n';
+    if (segment.used == 0) segment.firstTime = time;
+    segment.lastTime = time;
+    segment.used += length;
+    segment.records++;
+    mutex.give();
+    return true;
+}
+
+bool FileSink::handOff() {
+    if (handedOff.load(std::memory_order_acquire)) return false;
+    active ^= 1;
+    handedOff.store(true, std::memory_order_release);
+    return true;
+}
+
+void FileSink::flush() {
+    flushRequested = true;
+    // wait for the task to hand off the active segment, then for it to be written
+    while (flushRequested || handedOff) pros::delay(5);
+}
+
+void FileSink::taskLoop() {
+    while (!closing) {
+        if (!handedOff) {
+            // don't let messages sit in a segment that is filling slowly. A flush is only taken once the other
+            // segment is free, so the active one can be handed off
+            mutex.take();
+            const bool requested = flushRequested.exchange(false);
+            const Segment& segment = segments[active];
+            if (segment.used > 0 && (requested || pros::millis() - segment.firstTime >= FLUSH_PERIOD)) handOff();
+            mutex.give();
+        }
+        if (handedOff) writeSegment();
+        pros::delay(TASK_PERIOD);
+    }
+    taskDone = true;
+}
+
+uint32_t FileSink::getDropped() const { return dropped; }
+
+bool FileSink::openFile() {
+    if (file != nullptr) std::fclose(file);
+    if (index != nullptr) std::fclose(index);
+    file = nullptr;
+    index = nullptr;
+    fileSize = 0;
+    // skip files left by an earlier run
+    for (; fileNumber < MAX_FILES; fileNumber++) {
+        // big enough for any int
+        char number[16];
+        std::snprintf(number, sizeof(number), "_%03d", fileNumber);
+        const std::string path = prefix + number;
+        FILE* existing = std::fopen((path + ".log").c_str(), "rb");
+        if (existing != nullptr) {
+            std::fclose(existing);
+            continue;
+        }
+        file = std::fopen((path + ".log").c_str(), "wb");
+        index = std::fopen((path + ".idx").c_str(), "wb");
+        fileNumber++;
+        break;
+    }
+    if (file != nullptr && index != nullptr) return true;
+    // a file without its index can't be written, so close whichever one did open. The next segment tries again
+    if (file != nullptr) std::fclose(file);
+    if (index != nullptr) std::fclose(index);
+    file = nullptr;
+    index = nullptr;
+    return false;
+}
+
+void FileSink::writeSegment() {
+    Segment& segment = segments[active ^ 1];
+    SegmentHeader header {{MAGIC[0], MAGIC[1], MAGIC[2], MAGIC[3]},
+                          VERSION,
+                          0,
+                          0,
+                          uint32_t(segment.used),
+                          uint32_t(segment.used),
+                          segment.firstTime,
+                          segment.lastTime};
+    const char* data = segment.data.data();
+    if (compress) {
+        const size_t size = lz4Compress(reinterpret_cast<const uint8_t*>(data), segment.used, compressed.data(),
+                                        compressed.size(), matchTable.data());
+        // store the segment as it is if it didn't get smaller
+        if (size > 0 && size < segment.used) {
+            header.flags |= COMPRESSED;
+            header.storedSize = size;
+            data = reinterpret_cast<const char*>(compressed.data());
+        }
+    }
+    const size_t padded = (sizeof(header) + header.storedSize + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+
+    if ((file == nullptr || (fileSize > 0 && fileSize + padded > maxFileSize)) && !openFile()) {
+        dropped += segment.records;
+    } else {
+        const IndexEntry entry {uint32_t(fileSize), segment.firstTime, segment.lastTime};
+        static constexpr std::array<char, ALIGNMENT> zeros {};
+        std::fwrite(&header, sizeof(header), 1, file);
+        std::fwrite(data, 1, header.storedSize, file);
+        std::fwrite(zeros.data(), 1, padded - sizeof(header) - header.storedSize, file);
+        std::fflush(file);
+        std::fwrite(&entry, sizeof(entry), 1, index);
+        std::fflush(index);
+        fileSize += padded;
+    }
+
+    segment.used = 0;
+    segment.records = 0;
+    handedOff.store(false, std::memory_order_release);
+}
+} // namespace lemlib
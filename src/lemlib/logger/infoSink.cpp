@@ -1,11 +1,15 @@
 #include "lemlib/logger/infoSink.hpp"
 #include "lemlib/logger/message.hpp"
-#include "lemlib/logger/stdout.hpp"
+
+// longest color code, plus the code that resets the color and the newline
+constexpr size_t DECORATION_SIZE = 16;
 
 namespace lemlib {
 InfoSink::InfoSink() { setFormat("[LemLib] {level}: {message}"); }
 
-static std::string getColor(Level level) {
+InfoSink::~InfoSink() { stopQueue(); }
+
+static const char* getColor(Level level) {
     switch (level) {
         case Level::DEBUG: return "\033[0;36m"; // cyan
         case Level::INFO: return "\033[0;32m"; // green
@@ -17,6 +21,8 @@ static std::string getColor(Level level) {
 }
 
 void InfoSink::sendMessage(const Message& message) {
-    bufferedStdout().print("{}{}\033[0m\n", getColor(message.level), message.message);
+    // cut long messages short, so the color is always reset and the line always ends
+    const std::string_view text = message.message.substr(0, logArena().getSlabSize() - DECORATION_SIZE);
+    print(message.level, "{}{}\033[0m\n", getColor(message.level), text);
 }
 } // namespace lemlib
\ No newline at end of file
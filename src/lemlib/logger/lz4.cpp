@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <cstring>
+#include "lemlib/logger/lz4.hpp"
+
+// shortest match LZ4 can encode
+constexpr size_t MIN_MATCH = 4;
+// the last match has to start at least this many bytes before the end of the block
+constexpr size_t MATCH_FIND_LIMIT = 12;
+// the last bytes of a block are always literals
+constexpr size_t LAST_LITERALS = 5;
+// how far back a match can be
+constexpr size_t MAX_DISTANCE = 65535;
+// number of bits in the hash of 4 bytes
+constexpr int HASH_BITS = 12;
+static_assert(lemlib::LZ4_TABLE_SIZE == 1 << HASH_BITS, "every hash has an entry in the table");
+
+/**
+ * @brief Read 4 bytes, for comparing and hashing
+ */
+static uint32_t read32(const uint8_t* data) {
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief Write a length that didn't fit in its 4 bits of the token, as a run of 255s and the remainder
+ *
+ * @return false the output is full
+ */
+static bool writeLength(size_t length, uint8_t*& output, const uint8_t* end) {
+    for (; length >= 255; length -= 255) {
+        if (output >= end) return false;
+        *output++ = 255;
+    }
+    if (output >= end) return false;
+    *output++ = length;
+    return true;
+}
+
+/**
+ * @brief Write a sequence: some literals, followed by a match unless this is the last sequence
+ *
+ * @return false the output is full
+ */
+static bool writeSequence(const uint8_t* literals, size_t literalLength, size_t offset, size_t matchLength,
+                          uint8_t*& output, const uint8_t* end) {
+    if (output >= end) return false;
+    uint8_t* token = output++;
+    const size_t matchCode = matchLength == 0 ? 0 : matchLength - MIN_MATCH;
+    *token = (std::min<size_t>(literalLength, 15) << 4) | std::min<size_t>(matchCode, 15);
+    if (literalLength >= 15 && !writeLength(literalLength - 15, output, end)) return false;
+    if (size_t(end - output) < literalLength) return false;
+    std::memcpy(output, literals, literalLength);
+    output += literalLength;
+    if (matchLength == 0) return true;
+    if (end - output < 2) return false;
+    *output++ = offset & 0xFF;
+    *output++ = offset >> 8;
+    return matchCode < 15 || writeLength(matchCode - 15, output, end);
+}
+
+namespace lemlib {
+size_t lz4Compress(const uint8_t* data, size_t size, uint8_t* output, size_t capacity, uint32_t* table) {
+    uint8_t* position = output;
+    const uint8_t* end = output + capacity;
+    size_t anchor = 0;
+    if (size > MATCH_FIND_LIMIT) {
+        // last position each hash of 4 bytes was seen at, plus 1 so 0 means never
+        std::fill(table, table + LZ4_TABLE_SIZE, 0);
+        size_t i = 0;
+        while (i < size - MATCH_FIND_LIMIT) {
+            const uint32_t sequence = read32(data + i);
+            const uint32_t hash = (sequence * 2654435761u) >> (32 - HASH_BITS);
+            const size_t candidate = table[hash];
+            table[hash] = i + 1;
+            if (candidate == 0 || i - (candidate - 1) > MAX_DISTANCE || read32(data + candidate - 1) != sequence) {
+                i++;
+                continue;
+            }
+            const size_t match = candidate - 1;
+            size_t length = MIN_MATCH;
+            while (i + length < size - LAST_LITERALS && data[match + length] == data[i + length]) length++;
+            if (!writeSequence(data + anchor, i - anchor, i - match, length, position, end)) return 0;
+            i += length;
+            anchor = i;
+        }
+    }
+    if (!writeSequence(data + anchor, size - anchor, 0, 0, position, end)) return 0;
+    return position - output;
+}
+
+std::optional<std::vector<uint8_t>> lz4Decompress(const uint8_t* data, size_t size, size_t decompressedSize) {
+    std::vector<uint8_t> output;
+    output.reserve(decompressedSize);
+    size_t i = 0;
+    // read a length that continues past its 4 bits of the token
+    auto readLength = [&](size_t& length) {
+        uint8_t byte;
+        do {
+            if (i >= size) return false;
+            byte = data[i++];
+            length += byte;
+        } while (byte == 255);
+        return true;
+    };
+    while (i < size) {
+        const uint8_t token = data[i++];
+        size_t literalLength = token >> 4;
+        if (literalLength == 15 && !readLength(literalLength)) return std::nullopt;
+        if (size - i < literalLength) return std::nullopt;
+        output.insert(output.end(), data + i, data + i + literalLength);
+        i += literalLength;
+        // the last sequence has no match
+        if (i == size) break;
+        if (size - i < 2) return std::nullopt;
+        const size_t offset = data[i] | (data[i + 1] << 8);
+        i += 2;
+        size_t matchLength = token & 15;
+        if (matchLength == 15 && !readLength(matchLength)) return std::nullopt;
+        matchLength += MIN_MATCH;
+        if (offset == 0 || offset > output.size()) return std::nullopt;
+        // the match can overlap the bytes it produces, so copy one byte at a time
+        const size_t start = output.size() - offset;
+        for (size_t j = 0; j < matchLength; j++) output.push_back(output[start + j]);
+    }
+    if (output.size() != decompressedSize) return std::nullopt;
+    return output;
+}
+} // namespace lemlib
@@ -1,6 +1,12 @@
+#include <atomic>
 #include "lemlib/logger/message.hpp"
 
 namespace lemlib {
+uint32_t nextSequence() {
+    static std::atomic<uint32_t> sequence = 0;
+    return sequence.fetch_add(1, std::memory_order_relaxed);
+}
+
 std::string format_as(Level level) {
     switch (level) {
         case Level::DEBUG: return "DEBUG";
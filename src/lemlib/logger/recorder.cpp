@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "lemlib/logger/recorder.hpp"
+
+// identifies a recording, followed by the version of the format
+constexpr char MAGIC[4] = {'L', 'L', 'R', 'C'};
+constexpr uint8_t VERSION = 2;
+// how often the background task checks for full blocks, in milliseconds
+constexpr uint32_t FLUSH_PERIOD = 20;
+
+namespace lemlib {
+TelemetryRecorder::TelemetryRecorder(uint16_t rowsPerBlock, uint8_t blocks)
+    : rowsPerBlock(std::max<uint16_t>(rowsPerBlock, 1)),
+      blocks(std::max<uint8_t>(blocks, 2)) {}
+
+TelemetryRecorder::~TelemetryRecorder() {
+    stop();
+    if (task == nullptr) return;
+    // the task uses the recorder, so wait for it to finish before the recorder is destroyed
+    closing = true;
+    while (!taskDone) pros::delay(5);
+    delete task;
+}
+
+uint16_t TelemetryRecorder::addChannel(const std::string& name) {
+    if (recording) return UINT16_MAX;
+    names.push_back(name);
+    return channelCount++;
+}
+
+float* TelemetryRecorder::blockData(uint32_t block) {
+    return data.data() + size_t(block % blocks) * (channelCount + 1) * rowsPerBlock;
+}
+
+bool TelemetryRecorder::start(const std::string& path) {
+    if (recording) return false;
+    output = path.empty() ? stdout : std::fopen(path.c_str(), "wb");
+    if (output == nullptr) return false;
+
+    // all the memory is allocated up front. Channels that aren't recorded on a tick are left as NaN
+    data.assign(size_t(blocks) * (channelCount + 1) * rowsPerBlock, NAN);
+    rows.assign(blocks, 0);
+    filled = 0;
+    written = 0;
+    dropped = 0;
+
+    // header: magic, version, channel count, rows per block, then the name of each channel followed by a 0
+    std::fwrite(MAGIC, 1, sizeof(MAGIC), output);
+    std::fwrite(&VERSION, sizeof(VERSION), 1, output);
+    std::fwrite(&channelCount, sizeof(channelCount), 1, output);
+    std::fwrite(&rowsPerBlock, sizeof(rowsPerBlock), 1, output);
+    for (const std::string& name : names) std::fwrite(name.c_str(), 1, name.size() + 1, output);
+    std::fflush(output);
+
+    nextBlock();
+    recording = true;
+    if (task == nullptr) {
+        task = new pros::Task {[this] {
+            while (!closing) {
+                flush();
+                pros::delay(FLUSH_PERIOD);
+            }
+            taskDone = true;
+        }};
+    }
+    return true;
+}
+
+void TelemetryRecorder::stop() {
+    if (!recording) return;
+    recording = false;
+    // hand off the partly filled block
+    if (row != nullptr && rowIndex > 0) {
+        rows[filled % blocks] = rowIndex;
+        filled.fetch_add(1, std::memory_order_release);
+    }
+    row = nullptr;
+    while (written.load(std::memory_order_acquire) != filled.load(std::memory_order_relaxed)) pros::delay(5);
+    if (output != stdout) std::fclose(output);
+    output = nullptr;
+}
+
+void TelemetryRecorder::tick() {
+    if (!recording) return;
+    if (row == nullptr) {
+        // the samples of this tick had nowhere to go
+        dropped++;
+        nextBlock();
+        return;
+    }
+    // the timestamp column holds the bits of the low 32 bits of the time in microseconds, not the time converted to a
+    // float. The decoder adds back the rest
+    const uint32_t now = pros::micros();
+    std::memcpy(row, &now, sizeof(now));
+    row++;
+    if (++rowIndex < rowsPerBlock) return;
+    rows[filled % blocks] = rowIndex;
+    filled.fetch_add(1, std::memory_order_release);
+    nextBlock();
+}
+
+void TelemetryRecorder::nextBlock() {
+    const uint32_t block = filled.load(std::memory_order_relaxed);
+    if (block - written.load(std::memory_order_acquire) >= blocks) {
+        row = nullptr;
+        return;
+    }
+    rowIndex = 0;
+    row = blockData(block);
+}
+
+uint32_t TelemetryRecorder::getDropped() const { return dropped; }
+
+void TelemetryRecorder::flush() {
+    while (written.load(std::memory_order_relaxed) != filled.load(std::memory_order_acquire)) {
+        const uint32_t block = written.load(std::memory_order_relaxed);
+        const uint16_t count = rows[block % blocks];
+        float* start = blockData(block);
+        // block: number of rows, then the used part of each column
+        std::fwrite(&count, sizeof(count), 1, output);
+        for (int column = 0; column <= channelCount; column++)
+            std::fwrite(start + size_t(column) * rowsPerBlock, sizeof(float), count, output);
+        std::fflush(output);
+        // reset the block, so channels that aren't recorded next time are NaN
+        std::fill(start, start + size_t(channelCount + 1) * rowsPerBlock, NAN);
+        written.fetch_add(1, std::memory_order_release);
+    }
+}
+} // namespace lemlib
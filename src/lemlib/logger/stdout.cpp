@@ -7,6 +7,8 @@ namespace lemlib {
 BufferedStdout::BufferedStdout()
     : Buffer([](const std::string& text) { std::cout << text << std::flush; }) {
     setRate(50);
+    // every sink without a queue of its own shares this buffer, so errors need space of their own
+    setReservedSpace(512);
 }
 
 BufferedStdout& bufferedStdout() {
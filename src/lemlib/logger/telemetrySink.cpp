@@ -1,12 +1,18 @@
 #define FMT_HEADER_ONLY
 #include "fmt/format.h"
 #include "lemlib/logger/telemetrySink.hpp"
-#include "lemlib/logger/stdout.hpp"
+
+// the codes that save and restore the cursor and clear the line
+constexpr size_t DECORATION_SIZE = 10;
 
 namespace lemlib {
 TelemetrySink::TelemetrySink() { setFormat("TELE_{level}:{message}TELE_END"); }
 
+TelemetrySink::~TelemetrySink() { stopQueue(); }
+
 void TelemetrySink::sendMessage(const Message& message) {
-    bufferedStdout().print("\033[s{}\033[u\033[0J", message.message);
+    // cut long messages short, so the cursor is always restored
+    const std::string_view text = message.message.substr(0, logArena().getSlabSize() - DECORATION_SIZE);
+    print(message.level, "\033[s{}\033[u\033[0J", text);
 }
 } // namespace lemlib
@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <cmath>
+#include "lemlib/motionProfile.hpp"
+
+namespace lemlib {
+MotionProfile::MotionProfile(float distance, float maxVelocity, float maxAccel, float maxJerk)
+    : distance(distance),
+      jerk(maxJerk) {
+    // a profile that can't move is done instantly
+    if (distance <= 0 || maxVelocity <= 0 || maxAccel <= 0) return;
+
+    // calculates the shape of the acceleration phase for a given peak velocity
+    auto plan = [&](float velocity) {
+        peakVelocity = velocity;
+        if (jerk <= 0) { // trapezoidal, acceleration changes instantly
+            peakAccel = maxAccel;
+            jerkTime = 0;
+        } else { // s-curve, peak acceleration may not be reached if the peak velocity is low
+            peakAccel = std::min(maxAccel, std::sqrt(velocity * jerk));
+            jerkTime = peakAccel / jerk;
+        }
+        constAccelTime = std::max(velocity / peakAccel - jerkTime, 0.0f);
+        accelTime = 2 * jerkTime + constAccelTime;
+        // the acceleration phase is symmetric, so the average velocity is half the peak velocity
+        accelDistance = velocity * accelTime / 2;
+    };
+
+    // use the max velocity if there is enough room to accelerate and decelerate
+    // otherwise, binary search for the highest velocity that fits
+    plan(maxVelocity);
+    if (2 * accelDistance > distance) {
+        float low = 0;
+        float high = maxVelocity;
+        for (int i = 0; i < 32; i++) {
+            const float mid = (low + high) / 2;
+            plan(mid);
+            if (2 * accelDistance > distance) high = mid;
+            else low = mid;
+        }
+        plan(low);
+    }
+    if (peakVelocity > 0) cruiseTime = (distance - 2 * accelDistance) / peakVelocity;
+}
+
+ProfileState MotionProfile::sampleAccel(float time) const {
+    ProfileState state;
+    // first jerk section, acceleration is increasing
+    const float t1 = std::min(time, jerkTime);
+    state.acceleration = jerk * t1;
+    state.velocity = jerk * t1 * t1 / 2;
+    state.position = jerk * t1 * t1 * t1 / 6;
+    if (time <= jerkTime) return state;
+    // constant acceleration section
+    const float t2 = std::min(time - jerkTime, constAccelTime);
+    state.position += state.velocity * t2 + peakAccel * t2 * t2 / 2;
+    state.velocity += peakAccel * t2;
+    state.acceleration = peakAccel;
+    if (time <= jerkTime + constAccelTime) return state;
+    // second jerk section, acceleration is decreasing
+    const float t3 = std::min(time - jerkTime - constAccelTime, jerkTime);
+    state.position += state.velocity * t3 + peakAccel * t3 * t3 / 2 - jerk * t3 * t3 * t3 / 6;
+    state.velocity += peakAccel * t3 - jerk * t3 * t3 / 2;
+    state.acceleration = peakAccel - jerk * t3;
+    return state;
+}
+
+ProfileState MotionProfile::sample(float time) const {
+    ProfileState state;
+    if (time <= 0) return state;
+    if (time >= getDuration()) {
+        state.position = distance;
+        return state;
+    }
+    // accelerating
+    if (time < accelTime) return sampleAccel(time);
+    // cruising
+    if (time < accelTime + cruiseTime) {
+        state.position = accelDistance + peakVelocity * (time - accelTime);
+        state.velocity = peakVelocity;
+        return state;
+    }
+    // decelerating, mirror the acceleration phase
+    const ProfileState mirrored = sampleAccel(getDuration() - time);
+    state.position = distance - mirrored.position;
+    state.velocity = mirrored.velocity;
+    state.acceleration = -mirrored.acceleration;
+    return state;
+}
+
+float MotionProfile::getDuration() const { return 2 * accelTime + cruiseTime; }
+
+float MotionProfile::getPeakVelocity() const { return peakVelocity; }
+} // namespace lemlib
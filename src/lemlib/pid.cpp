@@ -1,6 +1,10 @@
+#include <algorithm>
 #include "pid.hpp"
 #include "util.hpp"
 
+// the update period the gains are in units of, in milliseconds
+constexpr float REFERENCE_PERIOD = 10;
+
 namespace lemlib {
 PID::PID(float kP, float kI, float kD, float windupRange, bool signFlipReset)
     : kP(kP),
@@ -9,22 +13,66 @@ PID::PID(float kP, float kI, float kD, float windupRange, bool signFlipReset)
       windupRange(windupRange),
       signFlipReset(signFlipReset) {}
 
-float PID::update(const float error) {
+float PID::update(const float error) { return update(error, REFERENCE_PERIOD); }
+
+float PID::update(const float error, float dt, std::optional<float> measurement) {
+    // a period of 0 would divide by 0, so fall back to the reference period
+    if (dt <= 0) dt = REFERENCE_PERIOD;
+    const float periods = dt / REFERENCE_PERIOD;
+
     // calculate integral
-    integral += error;
+    integral += error * periods;
     if (sgn(error) != sgn((prevError)) && signFlipReset) integral = 0;
     if (fabs(error) > windupRange && windupRange != 0) integral = 0;
 
     // calculate derivative
-    const float derivative = error - prevError;
+    float rawDerivative;
+    if (derivativeOnMeasurement && measurement) {
+        // the error decreases as the measurement increases, so the derivative is negated
+        rawDerivative = prevMeasurement ? -(*measurement - *prevMeasurement) / periods : 0;
+        prevMeasurement = measurement;
+    } else {
+        rawDerivative = (error - prevError) / periods;
+    }
     prevError = error;
+    // low pass filter the derivative
+    if (derivativeFilter > 0) derivative += (rawDerivative - derivative) * dt / (derivativeFilter + dt);
+    else derivative = rawDerivative;
 
     // calculate output
-    return error * kP + integral * kI + derivative * kD;
+    const float output = error * kP + integral * kI + derivative * kD;
+    if (outputLimit == 0) return output;
+
+    // limit the output, and drive the integral back by the amount the output was limited
+    const float limited = std::clamp(output, -outputLimit, outputLimit);
+    if (kI != 0) integral += (limited - output) / kI * trackingGain * periods;
+    return limited;
+}
+
+void PID::setDerivativeFilter(float timeConstant) { derivativeFilter = fabs(timeConstant); }
+
+void PID::setDerivativeOnMeasurement(bool enabled) { derivativeOnMeasurement = enabled; }
+
+void PID::setOutputLimit(float limit, float trackingGain) {
+    outputLimit = fabs(limit);
+    this->trackingGain = fabs(trackingGain);
+}
+
+void PID::setGains(float kP, float kI, float kD) {
+    this->kP = kP;
+    this->kI = kI;
+    this->kD = kD;
 }
 
 void PID::reset() {
     integral = 0;
     prevError = 0;
+    derivative = 0;
+    prevMeasurement = std::nullopt;
+}
+
+void PID::reset(float error) {
+    reset();
+    prevError = error;
 }
 } // namespace lemlib
\ No newline at end of file
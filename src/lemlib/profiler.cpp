@@ -0,0 +1,125 @@
+#include <array>
+#include <limits>
+#include "lemlib/profiler.hpp"
+#include "lemlib/logger/logger.hpp"
+
+namespace lemlib {
+#ifndef LEMLIB_DISABLE_PROFILER
+// the histogram uses 4 buckets per power of 2, so every bucket is at most 25% wide
+// times below 4us get their own bucket, and anything above ~1s goes in the last bucket
+constexpr int SUB_BUCKETS = 4;
+constexpr int MAX_OCTAVE = 20;
+constexpr int BUCKET_COUNT = SUB_BUCKETS + (MAX_OCTAVE - 2) * SUB_BUCKETS;
+
+/**
+ * @brief timing data of a single section
+ *
+ * sections are written by the task that runs them and read by whoever asks for statistics,
+ * so a read that races a write may be off by one sample. That's fine for a profiler
+ */
+struct SectionData {
+        uint32_t count = 0;
+        uint32_t min = std::numeric_limits<uint32_t>::max();
+        uint32_t max = 0;
+        uint64_t total = 0;
+        std::array<uint32_t, BUCKET_COUNT> buckets {};
+};
+
+static std::array<SectionData, static_cast<int>(ProfileSection::COUNT)> sections;
+
+/**
+ * @brief get the histogram bucket a time belongs in
+ *
+ * @param time time in microseconds
+ * @return int bucket index
+ */
+static int bucketIndex(uint32_t time) {
+    if (time < SUB_BUCKETS) return time;
+    const int octave = 31 - __builtin_clz(time);
+    if (octave >= MAX_OCTAVE) return BUCKET_COUNT - 1;
+    const int sub = (time >> (octave - 2)) & (SUB_BUCKETS - 1);
+    return SUB_BUCKETS + (octave - 2) * SUB_BUCKETS + sub;
+}
+
+/**
+ * @brief get the largest time that belongs in a bucket
+ *
+ * @param index bucket index
+ * @return uint32_t time in microseconds
+ */
+static uint32_t bucketUpperBound(int index) {
+    if (index < SUB_BUCKETS) return index;
+    const int octave = (index - SUB_BUCKETS) / SUB_BUCKETS + 2;
+    const int sub = (index - SUB_BUCKETS) % SUB_BUCKETS;
+    return ((SUB_BUCKETS + sub + 1) << (octave - 2)) - 1;
+}
+
+void recordSectionTime(ProfileSection section, uint32_t time) {
+    SectionData& data = sections[static_cast<int>(section)];
+    data.count++;
+    data.total += time;
+    if (time < data.min) data.min = time;
+    if (time > data.max) data.max = time;
+    data.buckets[bucketIndex(time)]++;
+}
+
+ProfileStats getSectionStats(ProfileSection section) {
+    const SectionData& data = sections[static_cast<int>(section)];
+    ProfileStats stats;
+    stats.count = data.count;
+    if (stats.count == 0) return stats;
+    stats.min = data.min;
+    stats.max = data.max;
+    stats.avg = float(data.total) / stats.count;
+    // find the first bucket where at least 99% of samples are at or below it
+    const uint64_t threshold = (uint64_t(stats.count) * 99 + 99) / 100;
+    uint64_t cumulative = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        cumulative += data.buckets[i];
+        if (cumulative >= threshold) {
+            stats.p99 = std::min(bucketUpperBound(i), stats.max);
+            break;
+        }
+    }
+    return stats;
+}
+
+void resetSectionStats() {
+    for (SectionData& data : sections) data = SectionData();
+}
+
+void logSectionStats() {
+    for (int i = 0; i < static_cast<int>(ProfileSection::COUNT); i++) {
+        const ProfileStats stats = getSectionStats(static_cast<ProfileSection>(i));
+        if (stats.count == 0) continue;
+        telemetrySink()->info("PROFILE:{},{},{},{:.1f},{},{}", static_cast<ProfileSection>(i), stats.count, stats.min,
+                              stats.avg, stats.p99, stats.max);
+    }
+}
+#else
+void recordSectionTime(ProfileSection section, uint32_t time) {}
+
+ProfileStats getSectionStats(ProfileSection section) { return {}; }
+
+void resetSectionStats() {}
+
+void logSectionStats() {}
+#endif
+
+std::string format_as(ProfileSection section) {
+    switch (section) {
+        case ProfileSection::ODOMETRY: return "ODOMETRY";
+        case ProfileSection::TURN_TO_HEADING: return "TURN_TO_HEADING";
+        case ProfileSection::TURN_TO_POINT: return "TURN_TO_POINT";
+        case ProfileSection::SWING_TO_HEADING: return "SWING_TO_HEADING";
+        case ProfileSection::SWING_TO_POINT: return "SWING_TO_POINT";
+        case ProfileSection::MOVE_TO_POINT: return "MOVE_TO_POINT";
+        case ProfileSection::MOVE_TO_POSE: return "MOVE_TO_POSE";
+        case ProfileSection::FOLLOW: return "FOLLOW";
+        case ProfileSection::LOGGER: return "LOGGER";
+        case ProfileSection::DRIVE_CURVE: return "DRIVE_CURVE";
+        case ProfileSection::COUNT: return "COUNT";
+    }
+    __builtin_unreachable();
+}
+} // namespace lemlib
@@ -1,48 +1,29 @@
-#include "pros/rtos.hpp"
 #include "lemlib/timer.hpp"
 
 using namespace lemlib;
 
-Timer::Timer(uint32_t time)
-    : period(time) {
-    lastTime = pros::millis();
+Timer::Timer(uint32_t time, Clock* clock)
+    : period(time),
+      clock(clock) {
+    resumeTime = clock->millis();
 }
 
-uint32_t Timer::getTimeSet() {
-    const uint32_t time = pros::millis(); // get time from RTOS
-    if (!paused) timeWaited += time - lastTime; // don't update if paused
-    lastTime = time; // update last time
-    return period;
-}
+uint32_t Timer::getTimeSet() const { return period; }
 
-uint32_t Timer::getTimeLeft() {
-    const uint32_t time = pros::millis(); // get time from RTOS
-    if (!paused) timeWaited += time - lastTime; // don't update if paused
-    lastTime = time; // update last time
-    const int delta = period - timeWaited; // calculate how much time is left
-    return (delta > 0) ? delta : 0; // return 0 if timer is done
+uint32_t Timer::getTimeLeft() const {
+    const uint32_t passed = getTimePassed();
+    return passed < period ? period - passed : 0; // return 0 if timer is done
 }
 
-uint32_t Timer::getTimePassed() {
-    const uint32_t time = pros::millis(); // get time from RTOS
-    if (!paused) timeWaited += time - lastTime; // don't update if paused
-    lastTime = time; // update last time;
-    return timeWaited;
+uint32_t Timer::getTimePassed() const {
+    // time doesn't pass while the timer is paused
+    if (paused) return timeWaited;
+    return timeWaited + (clock->millis() - resumeTime);
 }
 
-bool Timer::isDone() {
-    const uint32_t time = pros::millis(); // get time from RTOS
-    if (!paused) timeWaited += time - lastTime; // don't update if paused
-    lastTime = time; // update last time
-    const int delta = period - timeWaited; // calculate how much time is left
-    return delta <= 0;
-}
+bool Timer::isDone() const { return getTimePassed() >= period; }
 
-bool Timer::isPaused() {
-    const uint32_t time = pros::millis(); // get time from RTOS
-    if (!paused) timeWaited += time - lastTime; // don't update if paused
-    return paused;
-}
+bool Timer::isPaused() const { return paused; }
 
 void Timer::set(uint32_t time) {
     period = time; // set how long to wait
@@ -51,20 +32,20 @@ void Timer::set(uint32_t time) {
 
 void Timer::reset() {
     timeWaited = 0;
-    lastTime = pros::millis();
+    resumeTime = clock->millis();
 }
 
 void Timer::pause() {
-    if (!paused) lastTime = pros::millis();
+    if (!paused) timeWaited = getTimePassed();
     paused = true;
 }
 
 void Timer::resume() {
-    if (paused) lastTime = pros::millis();
+    if (paused) resumeTime = clock->millis();
     paused = false;
 }
 
 void Timer::waitUntilDone() {
-    do pros::delay(5);
+    do clock->delay(5);
     while (!this->isDone());
 }
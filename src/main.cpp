@@ -99,6 +99,7 @@ lemlib::Chassis chassis(drivetrain, linearController, angularController, sensors
 void initialize() {
     pros::lcd::initialize(); // initialize brain screen
     chassis.calibrate(); // calibrate sensors
+    chassis.setNominalVoltage(11.5); // 127 power always applies 11.5 volts, no matter how charged the battery is
 
     // the default rate is 50. however, if you need to change the rate, you
     // can do the following.
@@ -108,15 +109,21 @@ void initialize() {
     // for more information on how the formatting for the loggers
     // works, refer to the fmtlib docs
 
+    // send binary telemetry. Odometry sends the pose and velocity, and the chassis sends motor power and controller
+    // error on its own. Decode a capture of the terminal with sim/build/decode
+    const uint8_t driveChannel = lemlib::binaryTelemetry().addChannel("drive_output", {"compensation", "writes_saved"});
+    lemlib::binaryTelemetry().setEnabled(true);
+
     // thread to for brain screen and position logging
-    pros::Task screenTask([&]() {
+    pros::Task screenTask([=]() {
         while (true) {
             // print robot location to the brain screen
             pros::lcd::print(0, "X: %f", chassis.getPose().x); // x
             pros::lcd::print(1, "Y: %f", chassis.getPose().y); // y
             pros::lcd::print(2, "Theta: %f", chassis.getPose().theta); // heading
-            // log position telemetry
-            lemlib::telemetrySink()->info("Chassis pose: {}", chassis.getPose());
+            // log battery compensation and how many redundant motor writes were skipped
+            lemlib::binaryTelemetry().send(driveChannel,
+                                           {chassis.getVoltageCompensation(), float(chassis.getWritesSaved())});
             // delay to save resources
             pros::delay(50);
         }